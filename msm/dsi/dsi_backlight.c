@@ -132,13 +132,46 @@ static int dsi_backlight_lerp(u16 x1, u16 x2, u16 y1, u16 y2, u16 x, u32 *y)
 	return 0;
 }
 
+static int dsi_backlight_lerp_normal(struct dsi_backlight_config *bl,
+		int brightness, u32 *bl_lvl)
+{
+	/* map UI brightness into driver backlight level rounding it */
+	return dsi_backlight_lerp(
+		1, bl->brightness_max_level,
+		bl->bl_min_level ? : 1, bl->bl_max_level,
+		brightness, bl_lvl);
+}
+
+static int dsi_backlight_lerp_hbm(const struct hbm_range *range,
+		int brightness, u32 *bl_lvl)
+{
+	return dsi_backlight_lerp(
+		range->user_bri_start, range->user_bri_end,
+		range->panel_bri_start, range->panel_bri_end,
+		brightness, bl_lvl);
+}
+
+static inline const struct bl_table_entry *dsi_backlight_table_entry(
+		struct dsi_backlight_config *bl, int brightness)
+{
+	if (!bl->bl_table || brightness < 0 ||
+			(u32)brightness >= bl->bl_table_size)
+		return NULL;
+
+	return &bl->bl_table[brightness];
+}
+
 static u32 dsi_backlight_calculate_normal(struct dsi_backlight_config *bl,
 		int brightness)
 {
+	const struct bl_table_entry *entry;
 	u32 bl_lvl = 0;
 	int rc = 0;
 
-	if (bl->lut) {
+	entry = dsi_backlight_table_entry(bl, brightness);
+	if (entry) {
+		bl_lvl = entry->bl_lvl;
+	} else if (bl->lut) {
 		/*
 		 * look up panel brightness; the first entry in the LUT
 		 corresponds to userspace brightness level 1
@@ -148,11 +181,7 @@ static u32 dsi_backlight_calculate_normal(struct dsi_backlight_config *bl,
 		else
 			bl_lvl = bl->lut[brightness];
 	} else {
-		/* map UI brightness into driver backlight level rounding it */
-		rc = dsi_backlight_lerp(
-			1, bl->brightness_max_level,
-			bl->bl_min_level ? : 1, bl->bl_max_level,
-			brightness, &bl_lvl);
+		rc = dsi_backlight_lerp_normal(bl, brightness, &bl_lvl);
 		if (unlikely(rc))
 			pr_err("failed to linearly interpolate, brightness unmodified\n");
 	}
@@ -364,10 +393,18 @@ static u32 dsi_backlight_calculate_hbm(struct dsi_backlight_config *bl,
 	 * function, but if it does use the dimmest HBM range.
 	 */
 	u32 target_range = 0;
+	const struct bl_table_entry *entry;
 
+	entry = dsi_backlight_table_entry(bl, brightness);
 	if (likely(brightness)) {
-		rc = dsi_backlight_hbm_find_range(bl, brightness,
-			&target_range);
+		if (entry) {
+			target_range = entry->hbm_range;
+			rc = (target_range == BL_TABLE_RANGE_NONE) ?
+				-EINVAL : 0;
+		} else {
+			rc = dsi_backlight_hbm_find_range(bl, brightness,
+				&target_range);
+		}
 		if (rc) {
 			pr_err("Did not find a matching HBM range for brightness %d\n",
 				brightness);
@@ -393,13 +430,16 @@ static u32 dsi_backlight_calculate_hbm(struct dsi_backlight_config *bl,
 		}
 	}
 
-	rc = dsi_backlight_lerp(
-		range->user_bri_start, range->user_bri_end,
-		range->panel_bri_start, range->panel_bri_end,
-		brightness, &bl_lvl);
+	if (entry) {
+		bl_lvl = entry->hbm_lvl;
+		goto done;
+	}
+
+	rc = dsi_backlight_lerp_hbm(range, brightness, &bl_lvl);
 	if (unlikely(rc))
 		pr_err("hbm: failed to linearly interpolate, brightness unmodified\n");
 
+done:
 	pr_debug("hbm: user %d-%d, panel %d-%d\n",
 		range->user_bri_start, range->user_bri_end,
 		range->panel_bri_start, range->panel_bri_end);
@@ -436,6 +476,87 @@ static u32 dsi_backlight_calculate(struct dsi_backlight_config *bl,
 	return bl_lvl;
 }
 
+/*
+ * Fill in the als range column of the brightness table. Called with
+ * state_lock held whenever the notifier ranges change.
+ */
+static void dsi_backlight_table_update_als(struct dsi_backlight_config *bl)
+{
+	u32 i, range;
+
+	if (!bl->bl_table)
+		return;
+
+	for (i = 0; i < bl->bl_table_size; i++) {
+		if (dsi_panel_bl_find_range(bl, i, &range))
+			range = BL_TABLE_RANGE_NONE;
+		bl->bl_table[i].als_range = range;
+	}
+}
+
+/*
+ * Precompute the normal and HBM panel levels and range indices for every
+ * user space brightness level, so brightness updates only need a table
+ * lookup. Entries are produced by the same helpers used on the slow path,
+ * so the results are identical. On any interpolation error the table is
+ * dropped and the slow path, with its error reporting, is used instead.
+ */
+static int dsi_backlight_table_build(struct dsi_backlight_config *bl)
+{
+	struct bl_table_entry *table;
+	struct hbm_data *hbm = bl->hbm;
+	u32 i, range, size;
+	int rc = 0;
+
+	kvfree(bl->bl_table);
+	bl->bl_table = NULL;
+	bl->bl_table_size = 0;
+
+	size = bl->brightness_max_level + 1;
+	if (size > BL_TABLE_MAX_LEVELS) {
+		pr_debug("brightness table skipped for %u levels\n", size);
+		return 0;
+	}
+
+	table = kvcalloc(size, sizeof(*table), GFP_KERNEL);
+	if (!table)
+		return -ENOMEM;
+
+	for (i = 0; i < size; i++) {
+		if (bl->lut)
+			table[i].bl_lvl = bl->lut[i];
+		else
+			rc = dsi_backlight_lerp_normal(bl, i, &table[i].bl_lvl);
+		if (rc)
+			goto error;
+
+		table[i].hbm_range = BL_TABLE_RANGE_NONE;
+		if (!hbm)
+			continue;
+
+		range = 0;
+		if (i && dsi_backlight_hbm_find_range(bl, i, &range))
+			continue;
+
+		rc = dsi_backlight_lerp_hbm(&hbm->ranges[range], i,
+				&table[i].hbm_lvl);
+		if (rc)
+			goto error;
+		table[i].hbm_range = range;
+	}
+
+	bl->bl_table = table;
+	bl->bl_table_size = size;
+	dsi_backlight_table_update_als(bl);
+
+	return 0;
+
+error:
+	pr_warn("failed to build brightness table at level %u\n", i);
+	kvfree(table);
+	return rc;
+}
+
 static int dsi_backlight_update_status(struct backlight_device *bd)
 {
 	struct dsi_backlight_config *bl = bl_get_data(bd);
@@ -476,9 +597,18 @@ static int dsi_backlight_update_status(struct backlight_device *bd)
 		need_notify = true;
 		if (bl->bl_notifier && is_on_mode(bd->props.state)
 				&& !(dsi_panel_get_hbm(panel))) {
+			const struct bl_table_entry *entry;
 			u32 target_range = 0;
 
-			rc = dsi_panel_bl_find_range(bl, brightness, &target_range);
+			entry = dsi_backlight_table_entry(bl, brightness);
+			if (entry) {
+				target_range = entry->als_range;
+				rc = (target_range == BL_TABLE_RANGE_NONE) ?
+					-EINVAL : 0;
+			} else {
+				rc = dsi_panel_bl_find_range(bl, brightness,
+					&target_range);
+			}
 			if (rc) {
 				pr_err("unable to find range from the backlight table (%d)\n", rc);
 			} else if (bl->bl_notifier->cur_range != target_range) {
@@ -780,6 +910,7 @@ static ssize_t als_table_store(struct device *dev,
 	bl->bl_notifier->num_ranges = als_count;
 	for (i = 0; i < bl->bl_notifier->num_ranges; i++)
 		bl->bl_notifier->ranges[i] = ranges[i];
+	dsi_backlight_table_update_als(bl);
 
 	mutex_unlock(&bl->state_lock);
 
@@ -1352,6 +1483,10 @@ int dsi_panel_bl_unregister(struct dsi_panel *panel)
 	dsi_panel_bl_hbm_free(panel->parent, bl);
 	dsi_panel_bl_notifier_free(panel->parent, bl);
 
+	kvfree(bl->bl_table);
+	bl->bl_table = NULL;
+	bl->bl_table_size = 0;
+
 	return 0;
 }
 
@@ -1817,6 +1952,11 @@ int dsi_panel_bl_parse_config(struct device *parent, struct dsi_backlight_config
 		pr_debug("[%s] error while parsing backlight ranges, rc=%d\n",
 			panel->name, rc);
 
+	rc = dsi_backlight_table_build(bl);
+	if (rc)
+		pr_warn("[%s] brightness table unavailable, rc=%d\n",
+			panel->name, rc);
+
 	rc = utils->read_u32(utils->data, "google,dsi-bl-cmd-high-byte-offset",
 		&val);
 	if (rc) {
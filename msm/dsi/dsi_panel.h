@@ -30,6 +30,9 @@
 #define DSI_MODE_MAX 32
 #define HBM_RANGE_MAX 4
 
+#define BL_TABLE_MAX_LEVELS 8192
+#define BL_TABLE_RANGE_NONE 0xff
+
 #define BL_STATE_STANDBY	BL_CORE_FBBLANK
 #define BL_STATE_LP		BL_CORE_LP1
 #define BL_STATE_LP2		BL_CORE_LP2
@@ -179,6 +182,21 @@ struct bl_notifier_data {
 	u32 cur_range;
 };
 
+/*
+ * Precomputed result of the brightness calculations for one (scaled) user
+ * space brightness level, indexed by brightness.
+ */
+struct bl_table_entry {
+	/* Panel brightness when HBM is off */
+	u32 bl_lvl;
+	/* Panel brightness when HBM is on, valid if hbm_range is set */
+	u32 hbm_lvl;
+	/* HBM range index, BL_TABLE_RANGE_NONE if no range matches */
+	u8 hbm_range;
+	/* Backlight notifier (als) range index, BL_TABLE_RANGE_NONE if none */
+	u8 als_range;
+};
+
 struct dsi_backlight_config {
 	enum dsi_backlight_type type;
 	enum bl_update_flag bl_update;
@@ -200,6 +218,10 @@ struct dsi_backlight_config {
 	struct bl_notifier_data *bl_notifier;
 	struct hbm_data *hbm;
 
+	/* brightness lookup table, rebuilt when its inputs change */
+	struct bl_table_entry *bl_table;
+	u32 bl_table_size;
+
 	int en_gpio;
 	struct backlight_device *bl_device;
 	struct regulator *lab_vreg;
@@ -16,9 +16,13 @@
 
 #include <linux/atomic.h>
 #include <linux/completion.h>
+#include <linux/crc32.h>
+#include <linux/firmware.h>
 #include <linux/wait.h>
 #include <linux/kthread.h>
+#include <linux/sizes.h>
 #include <uapi/linux/sched/types.h>
+#include <asm/unaligned.h>
 #include <video/mipi_display.h>
 
 #include "dsi_display.h"
@@ -990,11 +994,41 @@ struct gamma_fixup_info {
 	u8 *panel_id;
 };
 
+/**
+ * struct gamma_cache_info - persistent copy of the native gamma tables
+ * @blob: serialized tables of all modes, NULL if none
+ * @len: size of @blob in bytes
+ * @skip_load: force the next table read to go to the panel
+ */
+struct gamma_cache_info {
+	u8 *blob;
+	size_t len;
+	bool skip_load;
+};
+
+/**
+ * struct gamma_stats - gamma read and mode switch instrumentation
+ * @read_us: duration of the last gamma table read
+ * @cache_hits: table reads served from the gamma cache
+ * @cache_misses: table reads that went to the panel
+ * @switch_last_us: duration of the last mode switch
+ * @switch_max_us: longest mode switch
+ */
+struct gamma_stats {
+	u64 read_us;
+	u32 cache_hits;
+	u32 cache_misses;
+	u64 switch_last_us;
+	u64 switch_max_us;
+};
+
 struct gamma_switch_data {
 	struct panel_switch_data base;
 	struct kthread_work gamma_work;
 	struct gamma_fixup_info fixup_gamma;
 	struct gamma_calibration_info cali_gamma;
+	struct gamma_cache_info cache;
+	struct gamma_stats stats;
 	u8 num_of_cali_gamma;
 	bool native_gamma_ready;
 };
@@ -1064,44 +1098,71 @@ static const struct s6e3hc2_gamma_packet s6e3hc2_gamma_packets[] = {
 	}},
 };
 
+#define S6E3HC2_NUM_GAMMA_PACKETS ARRAY_SIZE(s6e3hc2_gamma_packets)
+#define MAX_GAMMA_MSGS (MAX_GAMMA_PACKETS * MAX_GAMMA_PACKETS)
+
+/**
+ * struct s6e3hc2_gamma_batch - DSI messages of one gamma update, in send order
+ * @num_msgs: number of valid entries in @msgs
+ * @msgs: messages, pointing into the gamma tables of the mode
+ * @msgs.data: payload including the command byte
+ * @msgs.len: payload length
+ * @msgs.last: true if the message ends a group and triggers the transfer
+ */
+struct s6e3hc2_gamma_batch {
+	u32 num_msgs;
+	struct {
+		const u8 *data;
+		size_t len;
+		bool last;
+	} msgs[MAX_GAMMA_MSGS];
+};
+
 struct s6e3hc2_panel_data {
 	u8 *gamma_data[S6E3HC2_NUM_GAMMA_TABLES];
 	u8 *native_gamma_data[S6E3HC2_NUM_GAMMA_TABLES];
+	struct s6e3hc2_gamma_batch batch[S6E3HC2_NUM_GAMMA_PACKETS];
 };
 
-static void s6e3hc2_gamma_group_write(struct panel_switch_data *pdata,
-				struct s6e3hc2_panel_data *priv_data,
-				const struct s6e3hc2_gamma_packet_group *group)
-{
-	const struct s6e3hc2_gamma_info *info;
-	const void *data;
-	size_t len;
-	int i;
-
-	for (i = 0; i < group->num_packets; i++) {
-		const u32 ndx = group->packets[i].index;
-		const u32 max_size = group->packets[i].max_size;
-		const bool last_packet = (i + 1) == group->num_packets;
-
-		if (WARN(ndx >= S6E3HC2_NUM_GAMMA_TABLES, "invalid ndx=%d\n"))
-			continue;
-
-		data = priv_data->gamma_data[ndx];
-
-		if (WARN(!data, "Gamma table #%d not read\n", i))
-			continue;
-
-		info = &s6e3hc2_gamma_tables[ndx];
-		/* extra byte for the dsi command */
-		len = (max_size ?: info->len) + 1;
-
-		pr_debug("Writing %d bytes to 0x%02X gamma last: %d\n",
-			 len, info->cmd, last_packet);
-
-
-		if (IS_ERR_VALUE(panel_dsi_write_buf(pdata->panel, data, len,
-					last_packet)))
-			pr_warn("failed sending gamma cmd 0x%02x\n", info->cmd);
+/*
+ * s6e3hc2_gamma_compile_batches() flattens the packet groups of every
+ * brightness band into the message list sent on a gamma update. Table
+ * contents may change (calibration), but their location does not, so
+ * this only needs to run once per mode.
+ */
+static void s6e3hc2_gamma_compile_batches(struct s6e3hc2_panel_data *priv_data)
+{
+	const struct s6e3hc2_gamma_packet *packet;
+	const struct s6e3hc2_gamma_packet_group *group;
+	struct s6e3hc2_gamma_batch *batch;
+	int i, j, k;
+
+	for (i = 0; i < S6E3HC2_NUM_GAMMA_PACKETS; i++) {
+		packet = &s6e3hc2_gamma_packets[i];
+		batch = &priv_data->batch[i];
+		batch->num_msgs = 0;
+
+		for (j = 0; j < packet->num_groups; j++) {
+			group = &packet->groups[j];
+
+			for (k = 0; k < group->num_packets; k++) {
+				const u32 ndx = group->packets[k].index;
+				const u32 max_size = group->packets[k].max_size;
+
+				if (WARN(ndx >= S6E3HC2_NUM_GAMMA_TABLES,
+					 "invalid ndx=%d\n", ndx))
+					continue;
+
+				/* extra byte for the dsi command */
+				batch->msgs[batch->num_msgs].data =
+					priv_data->gamma_data[ndx];
+				batch->msgs[batch->num_msgs].len = (max_size ?:
+					s6e3hc2_gamma_tables[ndx].len) + 1;
+				batch->msgs[batch->num_msgs].last =
+					(k + 1) == group->num_packets;
+				batch->num_msgs++;
+			}
+		}
 	}
 }
 
@@ -1113,7 +1174,7 @@ static void s6e3hc2_gamma_update(struct panel_switch_data *pdata,
 				 const struct dsi_display_mode *mode)
 {
 	struct s6e3hc2_panel_data *priv_data;
-	const struct s6e3hc2_gamma_packet *packet = NULL;
+	const struct s6e3hc2_gamma_batch *batch = NULL;
 	int i, dbv;
 
 	if (unlikely(!mode || !mode->priv_info))
@@ -1125,22 +1186,31 @@ static void s6e3hc2_gamma_update(struct panel_switch_data *pdata,
 
 	dbv = pdata->panel->bl_config.bl_actual;
 
-	for (i = 0; i < ARRAY_SIZE(s6e3hc2_gamma_packets); i++) {
+	for (i = 0; i < S6E3HC2_NUM_GAMMA_PACKETS; i++) {
 		if (dbv < s6e3hc2_gamma_packets[i].dbv_threshold) {
-			packet = &s6e3hc2_gamma_packets[i];
+			batch = &priv_data->batch[i];
 			break;
 		}
 	}
 
-	if (!packet) {
+	if (!batch) {
 		pr_err("Unable to find packet for dbv=%02X\n", dbv);
 		return;
 	}
 
 	pr_debug("Found packet ndx=%d for dbv=%02X\n", i, dbv);
 
-	for (i = 0; i < packet->num_groups; i++)
-		s6e3hc2_gamma_group_write(pdata, priv_data, &packet->groups[i]);
+	for (i = 0; i < batch->num_msgs; i++) {
+		pr_debug("Writing %zu bytes to 0x%02X gamma last: %d\n",
+			 batch->msgs[i].len, batch->msgs[i].data[0],
+			 batch->msgs[i].last);
+
+		if (IS_ERR_VALUE(panel_dsi_write_buf(pdata->panel,
+				batch->msgs[i].data, batch->msgs[i].len,
+				batch->msgs[i].last)))
+			pr_warn("failed sending gamma cmd 0x%02x\n",
+				batch->msgs[i].data[0]);
+	}
 }
 
 static void s6e3hc2_gamma_update_reg_locked(struct panel_switch_data *pdata,
@@ -1283,7 +1353,7 @@ error:
 static int s6e3hc2_gamma_alloc_mode_memory(const struct dsi_display_mode *mode)
 {
 	struct s6e3hc2_panel_data *priv_data;
-	size_t offset, native_offset, total_size;
+	size_t offset, tables_size;
 	int i;
 	u8 *buf, *native_buf;
 
@@ -1293,25 +1363,21 @@ static int s6e3hc2_gamma_alloc_mode_memory(const struct dsi_display_mode *mode)
 	if (mode->priv_info->switch_data)
 		return 0;
 
-	total_size = sizeof(*priv_data);
-
+	tables_size = 0;
 	for (i = 0; i < S6E3HC2_NUM_GAMMA_TABLES; i++)
-		total_size += s6e3hc2_gamma_tables[i].len;
+		tables_size += s6e3hc2_gamma_tables[i].len;
 	/* add an extra byte for cmd */
-	total_size += S6E3HC2_NUM_GAMMA_TABLES;
-
-	/* hold native gamma */
-	native_offset = total_size;
-	total_size *= 2;
+	tables_size += S6E3HC2_NUM_GAMMA_TABLES;
 
-	priv_data = kmalloc(total_size, GFP_KERNEL);
+	/* gamma tables followed by native gamma tables */
+	priv_data = kmalloc(sizeof(*priv_data) + 2 * tables_size, GFP_KERNEL);
 	if (!priv_data)
 		return -ENOMEM;
 
 	/* use remaining data at the end of buffer */
-	buf = (u8 *)(priv_data);
-	offset = sizeof(*priv_data);
-	native_buf = buf + native_offset;
+	buf = (u8 *)(priv_data + 1);
+	native_buf = buf + tables_size;
+	offset = 0;
 
 	for (i = 0; i < S6E3HC2_NUM_GAMMA_TABLES; i++) {
 		const size_t len = s6e3hc2_gamma_tables[i].len;
@@ -1322,6 +1388,8 @@ static int s6e3hc2_gamma_alloc_mode_memory(const struct dsi_display_mode *mode)
 		offset += len + 1;
 	}
 
+	s6e3hc2_gamma_compile_batches(priv_data);
+
 	mode->priv_info->switch_data = priv_data;
 
 	return 0;
@@ -1454,12 +1522,270 @@ static int s6e3hc2_copy_gamma_table(u8 **dest_gamma, u8 **src_gamma)
 	return 0;
 }
 
+/*
+ * Reading the gamma tables back from the DDIC takes a few hundred ms, mostly
+ * due to the byte-wise flash access of the 90Hz tables. Since the tables of a
+ * given panel never change, a copy of them is kept in a blob that userspace
+ * can persist through the "gamma_cache" sysfs node, or that can be shipped as
+ * firmware. The blob is keyed by the panel serial number and the DDIC display
+ * ID, and only used when both match the connected panel.
+ */
+#define S6E3HC2_GAMMA_CACHE_FW		"s6e3hc2_gamma_cache.bin"
+#define S6E3HC2_GAMMA_CACHE_MAGIC	0x43414753 /* "SGAC" */
+#define S6E3HC2_GAMMA_CACHE_VERSION	1
+#define S6E3HC2_GAMMA_CACHE_KEY_LEN	32
+#define S6E3HC2_GAMMA_CACHE_MAX_SIZE	SZ_4K
+#define S6E3HC2_DISPLAY_ID_LEN		3
+
+/**
+ * struct s6e3hc2_gamma_cache_hdr - header of a serialized gamma cache
+ * @magic: S6E3HC2_GAMMA_CACHE_MAGIC
+ * @version: S6E3HC2_GAMMA_CACHE_VERSION
+ * @key_len: number of valid bytes in @key
+ * @num_modes: number of mode records following the header
+ * @mode_len: size of each mode record
+ * @crc: crc32 of all mode records
+ * @key: panel serial number followed by the DDIC display ID
+ *
+ * Each mode record holds the refresh rate as a __le32, followed by the
+ * payload of all gamma tables (without command byte) in table order.
+ */
+struct s6e3hc2_gamma_cache_hdr {
+	__le32 magic;
+	__le16 version;
+	__le16 key_len;
+	__le32 num_modes;
+	__le32 mode_len;
+	__le32 crc;
+	u8 key[S6E3HC2_GAMMA_CACHE_KEY_LEN];
+} __packed;
+
+static size_t s6e3hc2_gamma_cache_mode_len(void)
+{
+	size_t len = sizeof(__le32);
+	int i;
+
+	for (i = 0; i < S6E3HC2_NUM_GAMMA_TABLES; i++)
+		len += s6e3hc2_gamma_tables[i].len;
+
+	return len;
+}
+
+static int s6e3hc2_gamma_cache_key(struct panel_switch_data *pdata, u8 *key)
+{
+	struct dsi_panel *panel = pdata->panel;
+	const struct dsi_panel_sn_location *location =
+		&panel->vendor_info.location;
+	struct mipi_dsi_device *dsi = &panel->mipi_device;
+	u32 read_size, sn_len;
+	ssize_t rc;
+	u8 *buf;
+
+	if (!location->addr || !location->sn_length)
+		return -ENODEV;
+
+	sn_len = min_t(u32, location->sn_length,
+		       S6E3HC2_GAMMA_CACHE_KEY_LEN - S6E3HC2_DISPLAY_ID_LEN);
+	read_size = location->start_byte + location->sn_length;
+	buf = kmalloc(read_size, GFP_KERNEL);
+	if (!buf)
+		return -ENOMEM;
+
+	memset(key, 0, S6E3HC2_GAMMA_CACHE_KEY_LEN);
+
+	rc = mipi_dsi_dcs_read(dsi, location->addr, buf, read_size);
+	if (rc != read_size) {
+		rc = -EIO;
+		goto done;
+	}
+	memcpy(key, &buf[location->start_byte], sn_len);
+
+	rc = mipi_dsi_dcs_read(dsi, MIPI_DCS_GET_DISPLAY_ID, key + sn_len,
+			       S6E3HC2_DISPLAY_ID_LEN);
+	if (rc != S6E3HC2_DISPLAY_ID_LEN) {
+		rc = -EIO;
+		goto done;
+	}
+
+	rc = sn_len + S6E3HC2_DISPLAY_ID_LEN;
+done:
+	kfree(buf);
+	return rc;
+}
+
+static bool s6e3hc2_gamma_cache_valid(struct panel_switch_data *pdata,
+				      const u8 *blob, size_t len,
+				      const u8 *key, int key_len)
+{
+	const struct s6e3hc2_gamma_cache_hdr *hdr = (const void *)blob;
+	const size_t mode_len = s6e3hc2_gamma_cache_mode_len();
+	size_t num_modes;
+
+	if (len < sizeof(*hdr) ||
+	    le32_to_cpu(hdr->magic) != S6E3HC2_GAMMA_CACHE_MAGIC ||
+	    le16_to_cpu(hdr->version) != S6E3HC2_GAMMA_CACHE_VERSION ||
+	    le32_to_cpu(hdr->mode_len) != mode_len)
+		return false;
+
+	if (le16_to_cpu(hdr->key_len) != key_len ||
+	    memcmp(hdr->key, key, key_len)) {
+		pr_debug("gamma cache belongs to a different panel\n");
+		return false;
+	}
+
+	num_modes = le32_to_cpu(hdr->num_modes);
+	if (num_modes != pdata->panel->num_timing_nodes ||
+	    len != sizeof(*hdr) + num_modes * mode_len)
+		return false;
+
+	if (crc32_le(~0, blob + sizeof(*hdr), len - sizeof(*hdr)) !=
+	    le32_to_cpu(hdr->crc)) {
+		pr_warn("gamma cache checksum mismatch\n");
+		return false;
+	}
+
+	return true;
+}
+
+static int s6e3hc2_gamma_cache_apply(struct panel_switch_data *pdata,
+				     const u8 *blob)
+{
+	const struct s6e3hc2_gamma_cache_hdr *hdr = (const void *)blob;
+	const size_t mode_len = s6e3hc2_gamma_cache_mode_len();
+	const u8 *rec = blob + sizeof(*hdr);
+	const struct dsi_display_mode *mode;
+	u8 **gamma_data;
+	int i, j;
+
+	/* records are stored in display mode order, see the cache store */
+	if (le32_to_cpu(hdr->num_modes) != pdata->panel->num_timing_nodes)
+		return -EINVAL;
+
+	for_each_display_mode(i, mode, pdata->panel) {
+		const struct s6e3hc2_panel_data *priv_data =
+			mode->priv_info->switch_data;
+		const u8 *payload = rec + sizeof(__le32);
+
+		if (get_unaligned_le32(rec) != mode->timing.refresh_rate)
+			return -EINVAL;
+
+		gamma_data = priv_data->gamma_data;
+		for (j = 0; j < S6E3HC2_NUM_GAMMA_TABLES; j++) {
+			const struct s6e3hc2_gamma_info *info =
+				&s6e3hc2_gamma_tables[j];
+
+			gamma_data[j][0] = info->cmd;
+			memcpy(gamma_data[j] + 1, payload, info->len);
+			payload += info->len;
+		}
+
+		rec += mode_len;
+	}
+
+	return 0;
+}
+
+static int s6e3hc2_gamma_cache_load(struct gamma_switch_data *sdata,
+				    const u8 *key, int key_len)
+{
+	struct panel_switch_data *pdata = &sdata->base;
+	struct gamma_cache_info *cache = &sdata->cache;
+	const struct firmware *fw;
+	const struct dsi_display_mode *mode;
+	int i, rc;
+
+	if (cache->skip_load)
+		return -EAGAIN;
+
+	if (!cache->blob) {
+		rc = request_firmware_direct(&fw, S6E3HC2_GAMMA_CACHE_FW,
+					     pdata->panel->parent);
+		if (rc)
+			return rc;
+
+		if (fw->size <= S6E3HC2_GAMMA_CACHE_MAX_SIZE) {
+			cache->blob = kmemdup(fw->data, fw->size, GFP_KERNEL);
+			cache->len = cache->blob ? fw->size : 0;
+		}
+		release_firmware(fw);
+
+		if (!cache->blob)
+			return -ENOMEM;
+	}
+
+	if (!s6e3hc2_gamma_cache_valid(pdata, cache->blob, cache->len,
+				       key, key_len))
+		return -EINVAL;
+
+	for_each_display_mode(i, mode, pdata->panel) {
+		rc = s6e3hc2_gamma_alloc_mode_memory(mode);
+		if (rc)
+			return rc;
+	}
+
+	return s6e3hc2_gamma_cache_apply(pdata, cache->blob);
+}
+
+static void s6e3hc2_gamma_cache_store(struct gamma_switch_data *sdata,
+				      const u8 *key, int key_len)
+{
+	struct panel_switch_data *pdata = &sdata->base;
+	struct gamma_cache_info *cache = &sdata->cache;
+	const size_t mode_len = s6e3hc2_gamma_cache_mode_len();
+	const u32 num_modes = pdata->panel->num_timing_nodes;
+	const size_t len = sizeof(struct s6e3hc2_gamma_cache_hdr) +
+			   num_modes * mode_len;
+	struct s6e3hc2_gamma_cache_hdr *hdr;
+	const struct dsi_display_mode *mode;
+	u8 *blob, *rec;
+	int i, j;
+
+	if (len > S6E3HC2_GAMMA_CACHE_MAX_SIZE)
+		return;
+
+	blob = kzalloc(len, GFP_KERNEL);
+	if (!blob)
+		return;
+
+	rec = blob + sizeof(*hdr);
+	for_each_display_mode(i, mode, pdata->panel) {
+		const struct s6e3hc2_panel_data *priv_data =
+			mode->priv_info->switch_data;
+
+		put_unaligned_le32(mode->timing.refresh_rate, rec);
+		rec += sizeof(__le32);
+
+		for (j = 0; j < S6E3HC2_NUM_GAMMA_TABLES; j++) {
+			const size_t tlen = s6e3hc2_gamma_tables[j].len;
+
+			memcpy(rec, priv_data->gamma_data[j] + 1, tlen);
+			rec += tlen;
+		}
+	}
+
+	hdr = (struct s6e3hc2_gamma_cache_hdr *)blob;
+	hdr->magic = cpu_to_le32(S6E3HC2_GAMMA_CACHE_MAGIC);
+	hdr->version = cpu_to_le16(S6E3HC2_GAMMA_CACHE_VERSION);
+	hdr->key_len = cpu_to_le16(key_len);
+	hdr->num_modes = cpu_to_le32(num_modes);
+	hdr->mode_len = cpu_to_le32(mode_len);
+	hdr->crc = cpu_to_le32(crc32_le(~0, blob + sizeof(*hdr),
+				       len - sizeof(*hdr)));
+	memcpy(hdr->key, key, key_len);
+
+	kfree(cache->blob);
+	cache->blob = blob;
+	cache->len = len;
+}
+
 static int s6e3hc2_gamma_read_tables(struct panel_switch_data *pdata)
 {
 	struct gamma_switch_data *sdata;
 	const struct dsi_display_mode *mode;
 	struct mipi_dsi_device *dsi;
-	int i, rc = 0;
+	u8 key[S6E3HC2_GAMMA_CACHE_KEY_LEN];
+	ktime_t start;
+	int i, key_len, rc = 0;
 
 	if (unlikely(!pdata || !pdata->panel))
 		return -ENOENT;
@@ -1468,9 +1794,23 @@ static int s6e3hc2_gamma_read_tables(struct panel_switch_data *pdata)
 	if (sdata->native_gamma_ready)
 		return 0;
 
+	SDE_ATRACE_BEGIN(__func__);
+	start = ktime_get();
+
 	dsi = &pdata->panel->mipi_device;
-	if (DSI_WRITE_CMD_BUF(dsi, unlock_cmd))
+	if (DSI_WRITE_CMD_BUF(dsi, unlock_cmd)) {
+		SDE_ATRACE_END(__func__);
 		return -EFAULT;
+	}
+
+	key_len = s6e3hc2_gamma_cache_key(pdata, key);
+	if (key_len < 0)
+		pr_debug("gamma cache disabled, no panel key: %d\n", key_len);
+	else if (!s6e3hc2_gamma_cache_load(sdata, key, key_len)) {
+		sdata->stats.cache_hits++;
+		goto copy_native;
+	}
+	sdata->stats.cache_misses++;
 
 	for_each_display_mode(i, mode, pdata->panel) {
 		rc = s6e3hc2_gamma_read_mode(pdata, mode);
@@ -1486,6 +1826,11 @@ static int s6e3hc2_gamma_read_tables(struct panel_switch_data *pdata)
 		goto abort;
 	}
 
+	if (key_len >= 0)
+		s6e3hc2_gamma_cache_store(sdata, key, key_len);
+	sdata->cache.skip_load = false;
+
+copy_native:
 	for_each_display_mode(i, mode, pdata->panel) {
 		struct s6e3hc2_panel_data *priv_data =
 			mode->priv_info->switch_data;
@@ -1499,7 +1844,13 @@ static int s6e3hc2_gamma_read_tables(struct panel_switch_data *pdata)
 
 abort:
 	if (DSI_WRITE_CMD_BUF(dsi, lock_cmd))
-		return -EFAULT;
+		rc = -EFAULT;
+
+	sdata->stats.read_us = ktime_us_delta(ktime_get(), start);
+	SDE_ATRACE_END(__func__);
+
+	pr_debug("gamma tables ready in %lluus, rc=%d\n",
+		 sdata->stats.read_us, rc);
 
 	return rc;
 }
@@ -1577,6 +1928,7 @@ ssize_t debugfs_s6e3hc2_gamma_write(struct file *file,
 
 	mutex_lock(&pdata->panel->panel_lock);
 	sdata->native_gamma_ready = false;
+	sdata->cache.skip_load = true;
 	mutex_unlock(&pdata->panel->panel_lock);
 
 	return count;
@@ -1977,13 +2329,88 @@ gamma_store(struct device *dev, struct device_attribute *attr,
 
 struct device_attribute dev_attr_gamma = __ATTR_WO(gamma);
 
+static struct gamma_switch_data *gamma_cache_get_sdata(struct kobject *kobj)
+{
+	const struct dsi_display *display;
+	struct panel_switch_data *pdata;
+
+	display = dev_get_drvdata(kobj_to_dev(kobj));
+	if (unlikely(!display || !display->panel ||
+		     !display->panel->private_data))
+		return NULL;
+
+	pdata = display->panel->private_data;
+	if (unlikely(!pdata->funcs || !pdata->funcs->support_cali_gamma_store))
+		return NULL;
+
+	return container_of(pdata, struct gamma_switch_data, base);
+}
+
+static ssize_t gamma_cache_read(struct file *filp, struct kobject *kobj,
+				struct bin_attribute *attr, char *buf,
+				loff_t off, size_t count)
+{
+	struct gamma_switch_data *sdata = gamma_cache_get_sdata(kobj);
+	struct dsi_panel *panel;
+	ssize_t rc;
+
+	if (!sdata)
+		return -EINVAL;
+
+	panel = sdata->base.panel;
+	mutex_lock(&panel->panel_lock);
+	rc = memory_read_from_buffer(buf, count, &off, sdata->cache.blob,
+				     sdata->cache.len);
+	mutex_unlock(&panel->panel_lock);
+
+	return rc;
+}
+
+static ssize_t gamma_cache_write(struct file *filp, struct kobject *kobj,
+				 struct bin_attribute *attr, char *buf,
+				 loff_t off, size_t count)
+{
+	struct gamma_switch_data *sdata = gamma_cache_get_sdata(kobj);
+	struct dsi_panel *panel;
+	u8 *blob;
+
+	if (!sdata)
+		return -EINVAL;
+
+	/* the whole cache has to be written at once */
+	if (off || !count || count > S6E3HC2_GAMMA_CACHE_MAX_SIZE)
+		return -EINVAL;
+
+	blob = kmemdup(buf, count, GFP_KERNEL);
+	if (!blob)
+		return -ENOMEM;
+
+	panel = sdata->base.panel;
+	mutex_lock(&panel->panel_lock);
+	kfree(sdata->cache.blob);
+	sdata->cache.blob = blob;
+	sdata->cache.len = count;
+	sdata->cache.skip_load = false;
+	mutex_unlock(&panel->panel_lock);
+
+	return count;
+}
+
+static BIN_ATTR_RW(gamma_cache, 0);
+
 static struct attribute *gamma_attrs[] = {
 	&dev_attr_gamma.attr,
 	NULL
 };
 
+static struct bin_attribute *gamma_bin_attrs[] = {
+	&bin_attr_gamma_cache,
+	NULL
+};
+
 static const struct attribute_group gamma_group = {
 	.attrs = gamma_attrs,
+	.bin_attrs = gamma_bin_attrs,
 };
 
 static void
@@ -2111,6 +2538,16 @@ static struct panel_switch_data *s6e3hc2_switch_create(struct dsi_panel *panel)
 	kthread_init_work(&sdata->gamma_work, s6e3hc2_gamma_work);
 	debugfs_create_file("gamma", 0600, sdata->base.debug_root,
 			    &sdata->base, &s6e3hc2_read_gamma_fops);
+	debugfs_create_u64("gamma_read_us", 0400, sdata->base.debug_root,
+			   &sdata->stats.read_us);
+	debugfs_create_u32("gamma_cache_hits", 0400, sdata->base.debug_root,
+			   &sdata->stats.cache_hits);
+	debugfs_create_u32("gamma_cache_misses", 0400, sdata->base.debug_root,
+			   &sdata->stats.cache_misses);
+	debugfs_create_u64("switch_last_us", 0400, sdata->base.debug_root,
+			   &sdata->stats.switch_last_us);
+	debugfs_create_u64("switch_max_us", 0400, sdata->base.debug_root,
+			   &sdata->stats.switch_max_us);
 	s6e3hc2_gamma_create_fixup_info(panel, &sdata->fixup_gamma);
 
 	return &sdata->base;
@@ -2123,6 +2560,8 @@ static void s6e3hc2_switch_data_destroy(struct panel_switch_data *pdata)
 	sdata = container_of(pdata, struct gamma_switch_data, base);
 
 	s6e3hc2_gamma_release_fixup_info(&sdata->fixup_gamma);
+	kfree(sdata->cache.blob);
+	sdata->cache.blob = NULL;
 	panel_switch_data_deinit(pdata);
 	if (pdata->panel && pdata->panel->parent)
 		devm_kfree(pdata->panel->parent, sdata);
@@ -2138,12 +2577,17 @@ static int s6e3hc2_update_hbm(struct dsi_panel *panel)
 static void s6e3hc2_perform_switch(struct panel_switch_data *pdata,
 				   const struct dsi_display_mode *mode)
 {
+	struct gamma_switch_data *sdata;
 	struct dsi_panel *panel = pdata->panel;
 	struct mipi_dsi_device *dsi = &panel->mipi_device;
+	ktime_t start;
 
 	if (!mode)
 		return;
 
+	sdata = container_of(pdata, struct gamma_switch_data, base);
+	start = ktime_get();
+
 	if (DSI_WRITE_CMD_BUF(dsi, unlock_cmd))
 		return;
 
@@ -2153,6 +2597,10 @@ static void s6e3hc2_perform_switch(struct panel_switch_data *pdata,
 	s6e3hc2_te2_normal_mode_update(panel, false);
 
 	DSI_WRITE_CMD_BUF(dsi, lock_cmd);
+
+	sdata->stats.switch_last_us = ktime_us_delta(ktime_get(), start);
+	sdata->stats.switch_max_us = max(sdata->stats.switch_max_us,
+					 sdata->stats.switch_last_us);
 }
 
 int s6e3hc2_send_nolp_cmds(struct dsi_panel *panel)
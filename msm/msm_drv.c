@@ -44,6 +44,7 @@
 #include <drm/drm_of.h>
 
 #include "msm_drv.h"
+#include "msm_gem.h"
 #include "msm_kms.h"
 #include "msm_mmu.h"
 #include "sde_wb.h"
@@ -394,6 +395,8 @@ static int msm_drm_uninit(struct device *dev)
 	flush_workqueue(priv->wq);
 	destroy_workqueue(priv->wq);
 
+	msm_gem_pool_destroy(ddev);
+
 	if (kms && kms->funcs)
 		kms->funcs->destroy(kms);
 
@@ -910,6 +913,10 @@ static int msm_drm_init(struct device *dev, struct drm_driver *drv)
 	if (ret)
 		goto bind_fail;
 
+	ret = msm_gem_pool_init(ddev);
+	if (ret)
+		goto fail;
+
 	ret = msm_init_vram(ddev);
 	if (ret)
 		goto fail;
@@ -974,6 +981,8 @@ static int msm_drm_init(struct device *dev, struct drm_driver *drv)
 		goto fail;
 	}
 
+	msm_gem_pool_debugfs_register(ddev, priv->debug_root);
+
 	/* perform subdriver post initialization */
 	if (kms && kms->funcs && kms->funcs->postinit) {
 		ret = kms->funcs->postinit(kms);
@@ -1615,6 +1624,30 @@ void msm_mode_object_event_notify(struct drm_mode_object *obj,
 	spin_unlock_irqrestore(&dev->event_lock, flags);
 }
 
+bool msm_mode_object_event_has_client(struct drm_mode_object *obj,
+		struct drm_device *dev, u32 type)
+{
+	struct msm_drm_private *priv = (dev) ? dev->dev_private : NULL;
+	struct msm_drm_event *node;
+	unsigned long flags;
+	bool found = false;
+
+	if (!obj || !priv)
+		return false;
+
+	spin_lock_irqsave(&dev->event_lock, flags);
+	list_for_each_entry(node, &priv->client_event_list, base.link) {
+		if (node->event.base.type == type &&
+				obj->id == node->event.info.object_id) {
+			found = true;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&dev->event_lock, flags);
+
+	return found;
+}
+
 static int msm_release(struct inode *inode, struct file *filp)
 {
 	struct drm_file *file_priv = filp->private_data;
@@ -2239,6 +2272,7 @@ static void __exit msm_drm_unregister(void)
 	msm_edp_unregister();
 	msm_dsi_unregister();
 	msm_smmu_driver_cleanup();
+	sde_hw_catalog_cache_free();
 }
 
 #ifdef CONFIG_DRM_MSM_MODULE
@@ -62,6 +62,7 @@ struct msm_gem_submit;
 struct msm_fence_context;
 struct msm_fence_cb;
 struct msm_gem_address_space;
+struct msm_gem_pool;
 struct msm_gem_vma;
 
 #define NUM_DOMAINS    4    /* one for KMS, then one per gpu core (?) */
@@ -708,6 +709,9 @@ struct msm_drm_private {
 	bool shutdown_in_progress;
 
 	struct msm_idle idle;
+
+	/* pool of imported dma-buf mappings kept alive after release */
+	struct msm_gem_pool *gem_pool;
 };
 
 /* get struct msm_kms * from drm_device * */
@@ -942,6 +946,16 @@ struct msm_dsi;
  */
 void msm_mode_object_event_notify(struct drm_mode_object *obj,
 		struct drm_device *dev, struct drm_event *event, u8 *payload);
+
+/* *
+ * msm_mode_object_event_has_client - check for clients of an object event
+ * @obj: mode object (crtc/connector) that generates the event.
+ * @dev: drm device.
+ * @type: event type.
+ * Returns: true if at least one client registered for the event
+ */
+bool msm_mode_object_event_has_client(struct drm_mode_object *obj,
+		struct drm_device *dev, u32 type);
 #ifndef CONFIG_DRM_MSM_DSI
 void __init msm_dsi_register(void);
 void __exit msm_dsi_unregister(void);
@@ -354,6 +354,8 @@ static struct msm_gem_vma *add_vma(struct drm_gem_object *obj,
 	msm_obj->aspace = aspace;
 
 	list_add_tail(&vma->list, &msm_obj->vmas);
+	if (aspace && aspace->vma_slot >= 0)
+		msm_obj->vma_index[aspace->vma_slot] = vma;
 
 	return vma;
 }
@@ -366,6 +368,10 @@ static struct msm_gem_vma *lookup_vma(struct drm_gem_object *obj,
 
 	WARN_ON(!mutex_is_locked(&msm_obj->lock));
 
+	/* the index is authoritative for address spaces that own a slot */
+	if (aspace && aspace->vma_slot >= 0)
+		return msm_obj->vma_index[aspace->vma_slot];
+
 	list_for_each_entry(vma, &msm_obj->vmas, list) {
 		if (vma->aspace == aspace)
 			return vma;
@@ -374,11 +380,15 @@ static struct msm_gem_vma *lookup_vma(struct drm_gem_object *obj,
 	return NULL;
 }
 
-static void del_vma(struct msm_gem_vma *vma)
+static void del_vma(struct msm_gem_object *msm_obj, struct msm_gem_vma *vma)
 {
 	if (!vma)
 		return;
 
+	if (vma->aspace && vma->aspace->vma_slot >= 0 &&
+			msm_obj->vma_index[vma->aspace->vma_slot] == vma)
+		msm_obj->vma_index[vma->aspace->vma_slot] = NULL;
+
 	list_del(&vma->list);
 	kfree(vma);
 }
@@ -401,7 +411,7 @@ put_iova(struct drm_gem_object *obj)
 		 * update the active_list during gem_free_obj and gem_purge.
 		 */
 		msm_obj->aspace = vma->aspace;
-		del_vma(vma);
+		del_vma(msm_obj, vma);
 	}
 }
 
@@ -421,12 +431,14 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 	}
 
 	vma = lookup_vma(obj, aspace);
+	msm_gem_pool_stat_vma(obj->dev, vma != NULL);
 
 	if (!vma) {
 		struct page **pages;
 		struct device *dev;
 		struct dma_buf *dmabuf;
 		bool reattach = false;
+		ktime_t start = ktime_get();
 
 		dev = msm_gem_get_aspace_device(aspace);
 		if ((dev && obj->import_attach) &&
@@ -481,6 +493,9 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 				msm_obj->flags);
 		if (ret)
 			goto fail;
+
+		msm_gem_pool_stat_map(obj->dev,
+				ktime_to_ns(ktime_sub(ktime_get(), start)));
 	}
 
 	*iova = vma->iova;
@@ -495,7 +510,7 @@ int msm_gem_get_iova(struct drm_gem_object *obj,
 	return 0;
 
 fail:
-	del_vma(vma);
+	del_vma(msm_obj, vma);
 unlock:
 	mutex_unlock(&msm_obj->lock);
 	return ret;
@@ -30,6 +30,9 @@
 
 struct msm_gem_object;
 
+/* number of address spaces with O(1) vma lookup in each gem object */
+#define MSM_GEM_VMA_SLOTS    4
+
 struct msm_gem_aspace_ops {
 	int (*map)(struct msm_gem_address_space *space, struct msm_gem_vma *vma,
 		struct sg_table *sgt, int npages, unsigned int flags);
@@ -75,6 +78,8 @@ struct msm_gem_address_space {
 	/* list of clients */
 	struct list_head clients;
 	struct mutex list_lock; /* Protects active_list & clients */
+	/* index into msm_gem_object::vma_index, -1 if not indexed */
+	int vma_slot;
 };
 
 struct msm_gem_vma {
@@ -122,6 +127,8 @@ struct msm_gem_object {
 	void *vaddr;
 
 	struct list_head vmas;    /* list of msm_gem_vma */
+	/* vmas of indexed address spaces, by msm_gem_address_space::vma_slot */
+	struct msm_gem_vma *vma_index[MSM_GEM_VMA_SLOTS];
 
 	/* normally (resv == &_resv) except for imported bo's */
 	struct reservation_object *resv;
@@ -180,6 +187,41 @@ enum msm_gem_lock {
 void msm_gem_purge(struct drm_gem_object *obj, enum msm_gem_lock subclass);
 void msm_gem_vunmap(struct drm_gem_object *obj, enum msm_gem_lock subclass);
 
+/**
+ * msm_gem_pool_init - create the gem mapping statistics
+ * @dev: drm device
+ * Return: 0 on success, negative error code otherwise
+ */
+int msm_gem_pool_init(struct drm_device *dev);
+
+/**
+ * msm_gem_pool_destroy - release the gem mapping statistics
+ * @dev: drm device
+ */
+void msm_gem_pool_destroy(struct drm_device *dev);
+
+/**
+ * msm_gem_pool_debugfs_register - expose the gem mapping statistics
+ * @dev: drm device
+ * @parent: debugfs directory to create the nodes under
+ */
+void msm_gem_pool_debugfs_register(struct drm_device *dev,
+		struct dentry *parent);
+
+/**
+ * msm_gem_pool_stat_vma - account a vma lookup of msm_gem_get_iova
+ * @dev: drm device
+ * @hit: true if an existing vma was found
+ */
+void msm_gem_pool_stat_vma(struct drm_device *dev, bool hit);
+
+/**
+ * msm_gem_pool_stat_map - account the time spent mapping a gem object
+ * @dev: drm device
+ * @ns: duration of the import and map in nanoseconds
+ */
+void msm_gem_pool_stat_map(struct drm_device *dev, u64 ns);
+
 /* Created per submit-ioctl, to track bo's and cmdstream bufs, etc,
  * associated with the cmdstream submission for synchronization (and
  * make it easier to unwind when things go wrong, etc).  This only
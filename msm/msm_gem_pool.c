@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ */
+
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+
+#include "msm_drv.h"
+#include "msm_gem.h"
+
+/**
+ * struct msm_gem_pool - statistics of gem object mapping
+ * @vma_hits: msm_gem_get_iova calls that found an existing vma
+ * @vma_misses: msm_gem_get_iova calls that had to map the object
+ * @map_count: number of timed import and map operations
+ * @map_ns_total: accumulated time of the timed operations
+ * @map_ns_max: longest timed operation
+ *
+ * Imported dma-bufs are not pooled here: their iommu mapping is already
+ * kept across imports by DMA_ATTR_DELAYED_UNMAP until the buffer is freed.
+ */
+struct msm_gem_pool {
+	atomic64_t vma_hits;
+	atomic64_t vma_misses;
+	atomic64_t map_count;
+	atomic64_t map_ns_total;
+	atomic64_t map_ns_max;
+};
+
+static struct msm_gem_pool *_msm_gem_pool_get(struct drm_device *dev)
+{
+	struct msm_drm_private *priv = dev ? dev->dev_private : NULL;
+
+	return priv ? priv->gem_pool : NULL;
+}
+
+void msm_gem_pool_stat_vma(struct drm_device *dev, bool hit)
+{
+	struct msm_gem_pool *pool = _msm_gem_pool_get(dev);
+
+	if (!pool)
+		return;
+
+	if (hit)
+		atomic64_inc(&pool->vma_hits);
+	else
+		atomic64_inc(&pool->vma_misses);
+}
+
+void msm_gem_pool_stat_map(struct drm_device *dev, u64 ns)
+{
+	struct msm_gem_pool *pool = _msm_gem_pool_get(dev);
+	s64 old, prev;
+
+	if (!pool)
+		return;
+
+	atomic64_inc(&pool->map_count);
+	atomic64_add(ns, &pool->map_ns_total);
+
+	old = atomic64_read(&pool->map_ns_max);
+	while ((s64)ns > old) {
+		prev = atomic64_cmpxchg(&pool->map_ns_max, old, ns);
+		if (prev == old)
+			break;
+		old = prev;
+	}
+}
+
+int msm_gem_pool_init(struct drm_device *dev)
+{
+	struct msm_drm_private *priv = dev->dev_private;
+	struct msm_gem_pool *pool;
+
+	pool = kzalloc(sizeof(*pool), GFP_KERNEL);
+	if (!pool)
+		return -ENOMEM;
+
+	priv->gem_pool = pool;
+
+	return 0;
+}
+
+void msm_gem_pool_destroy(struct drm_device *dev)
+{
+	struct msm_drm_private *priv = dev->dev_private;
+	struct msm_gem_pool *pool = priv->gem_pool;
+
+	if (!pool)
+		return;
+
+	priv->gem_pool = NULL;
+	kfree(pool);
+}
+
+#ifdef CONFIG_DEBUG_FS
+static int _msm_gem_pool_stats_show(struct seq_file *s, void *data)
+{
+	struct msm_gem_pool *pool = s->private;
+	u64 map_count, map_ns_total;
+
+	map_count = atomic64_read(&pool->map_count);
+	map_ns_total = atomic64_read(&pool->map_ns_total);
+
+	seq_printf(s, "vma hits: %lld misses: %lld\n",
+			atomic64_read(&pool->vma_hits),
+			atomic64_read(&pool->vma_misses));
+	seq_printf(s, "map count: %llu avg_ns: %llu max_ns: %lld\n",
+			map_count,
+			map_count ? div64_u64(map_ns_total, map_count) : 0,
+			atomic64_read(&pool->map_ns_max));
+
+	return 0;
+}
+
+static int _msm_gem_pool_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, _msm_gem_pool_stats_show, inode->i_private);
+}
+
+static const struct file_operations msm_gem_pool_stats_fops = {
+	.open = _msm_gem_pool_stats_open,
+	.read = seq_read,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+void msm_gem_pool_debugfs_register(struct drm_device *dev,
+		struct dentry *parent)
+{
+	struct msm_gem_pool *pool = _msm_gem_pool_get(dev);
+	struct dentry *dir;
+
+	if (!pool || !parent)
+		return;
+
+	dir = debugfs_create_dir("gem_pool", parent);
+	if (IS_ERR_OR_NULL(dir)) {
+		DRM_ERROR("failed to create gem_pool debugfs\n");
+		return;
+	}
+
+	debugfs_create_file("stats", 0400, dir, pool,
+			&msm_gem_pool_stats_fops);
+}
+#else
+void msm_gem_pool_debugfs_register(struct drm_device *dev,
+		struct dentry *parent)
+{
+}
+#endif /* CONFIG_DEBUG_FS */
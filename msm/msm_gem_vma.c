@@ -16,10 +16,31 @@
  * this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <linux/idr.h>
+
 #include "msm_drv.h"
 #include "msm_gem.h"
 #include "msm_mmu.h"
 
+/* slots of msm_gem_object::vma_index handed out to address spaces */
+static DEFINE_IDA(msm_gem_vma_slot_ida);
+
+static void msm_gem_vma_slot_get(struct msm_gem_address_space *aspace)
+{
+	int slot = ida_simple_get(&msm_gem_vma_slot_ida, 0,
+			MSM_GEM_VMA_SLOTS, GFP_KERNEL);
+
+	/* out of slots, lookups for this aspace fall back to the list */
+	aspace->vma_slot = slot < 0 ? -1 : slot;
+}
+
+static void msm_gem_vma_slot_put(struct msm_gem_address_space *aspace)
+{
+	if (aspace->vma_slot >= 0)
+		ida_simple_remove(&msm_gem_vma_slot_ida, aspace->vma_slot);
+	aspace->vma_slot = -1;
+}
+
 /* SDE address space operations */
 static void smmu_aspace_unmap_vma(struct msm_gem_address_space *aspace,
 		struct msm_gem_vma *vma, struct sg_table *sgt,
@@ -187,6 +208,7 @@ msm_gem_smmu_address_space_create(struct drm_device *dev, struct msm_mmu *mmu,
 	INIT_LIST_HEAD(&aspace->clients);
 	kref_init(&aspace->kref);
 	mutex_init(&aspace->list_lock);
+	msm_gem_vma_slot_get(aspace);
 
 	return aspace;
 }
@@ -200,6 +222,7 @@ msm_gem_address_space_destroy(struct kref *kref)
 	if (aspace && aspace->ops->destroy)
 		aspace->ops->destroy(aspace);
 
+	msm_gem_vma_slot_put(aspace);
 	kfree(aspace);
 }
 
@@ -308,6 +331,7 @@ msm_gem_address_space_create(struct device *dev, struct iommu_domain *domain,
 		size >> PAGE_SHIFT);
 
 	kref_init(&aspace->kref);
+	msm_gem_vma_slot_get(aspace);
 
 	return aspace;
 }
@@ -6,6 +6,8 @@
 #define pr_fmt(fmt)	"%s: " fmt, __func__
 
 #include <linux/dma-buf.h>
+#include <linux/crc32.h>
+#include <linux/vmalloc.h>
 #include <drm/msm_drm_pp.h>
 #include "sde_color_processing.h"
 #include "sde_kms.h"
@@ -31,6 +33,7 @@ struct sde_cp_node {
 	bool is_dspp_feature;
 	u32 prop_blob_sz;
 	struct sde_irq_callback *irq;
+	u32 payload_crc;
 };
 
 struct sde_cp_prop_attach {
@@ -721,6 +724,7 @@ static void sde_cp_get_hw_payload(struct sde_cp_node *prop_node,
 		if (blob) {
 			hw_cfg->len = blob->length;
 			hw_cfg->payload = blob->data;
+			hw_cfg->payload_crc = prop_node->payload_crc;
 			*feature_enabled = true;
 		}
 	} else if (prop_node->prop_flags & DRM_MODE_PROP_RANGE) {
@@ -735,6 +739,8 @@ static void sde_cp_get_hw_payload(struct sde_cp_node *prop_node,
 					0;
 			hw_cfg->payload = (prop_node->prop_val) ? blob->data
 						: NULL;
+			hw_cfg->payload_crc = (prop_node->prop_val) ?
+					prop_node->payload_crc : 0;
 		}
 		if (prop_node->prop_val)
 			*feature_enabled = true;
@@ -747,6 +753,20 @@ static void sde_cp_get_hw_payload(struct sde_cp_node *prop_node,
 	}
 }
 
+/*
+ * sde_cp_update_payload_crc - key the blob payload of a property so the hw
+ * layer can reuse payloads it already built for identical content
+ */
+static void sde_cp_update_payload_crc(struct sde_cp_node *prop_node)
+{
+	struct drm_property_blob *blob = prop_node->blob_ptr;
+
+	prop_node->payload_crc = 0;
+	if (blob && blob->length)
+		prop_node->payload_crc = crc32_le(~0, blob->data,
+				blob->length);
+}
+
 static int sde_cp_disable_crtc_blob_property(struct sde_cp_node *prop_node)
 {
 	struct drm_property_blob *blob = prop_node->blob_ptr;
@@ -938,6 +958,15 @@ void sde_cp_crtc_init(struct drm_crtc *crtc)
 	if (IS_ERR(sde_crtc->hist_blob))
 		sde_crtc->hist_blob = NULL;
 
+	/* ring of histogram frames shared read-only with user space */
+	sde_crtc->hist_ring = vmalloc_user(SDE_CP_HIST_RING_SIZE);
+	if (sde_crtc->hist_ring) {
+		sde_crtc->hist_ring->version = SDE_CP_HIST_RING_VERSION;
+		sde_crtc->hist_ring->num_slots = SDE_CP_HIST_RING_SLOTS;
+		sde_crtc->hist_ring->slot_size =
+			sizeof(struct sde_cp_hist_slot);
+	}
+
 	mutex_init(&sde_crtc->crtc_cp_lock);
 	INIT_LIST_HEAD(&sde_crtc->active_list);
 	INIT_LIST_HEAD(&sde_crtc->dirty_list);
@@ -1498,6 +1527,7 @@ int sde_cp_crtc_set_property(struct drm_crtc *crtc,
 						  prop_node, val);
 
 	if (!ret) {
+		sde_cp_update_payload_crc(prop_node);
 		/* remove the property from active list */
 		list_del_init(&prop_node->active_list);
 		/* Mark the feature as dirty */
@@ -1571,6 +1601,9 @@ void sde_cp_crtc_destroy_properties(struct drm_crtc *crtc)
 	if (sde_crtc->hist_blob)
 		drm_property_blob_put(sde_crtc->hist_blob);
 
+	vfree(sde_crtc->hist_ring);
+	sde_crtc->hist_ring = NULL;
+
 	for (i = 0; i < sde_crtc->ltm_buffer_cnt; i++) {
 		if (sde_crtc->ltm_buffers[i]) {
 			msm_gem_put_vaddr(sde_crtc->ltm_buffers[i]->gem);
@@ -2434,6 +2467,8 @@ static void sde_cp_hist_interrupt_cb(void *arg, int irq_idx)
 	}
 	spin_unlock_irqrestore(&node->state_lock, flags);
 
+	crtc->hist_irq_time = ktime_get();
+
 	/* lock histogram buffer */
 	for (i = 0; i < crtc->num_mixers; i++) {
 		hw_dspp = crtc->mixers[i].hw_dspp;
@@ -2452,9 +2487,11 @@ static void sde_cp_notify_hist_event(struct drm_crtc *crtc_drm, void *arg)
 	struct sde_crtc *crtc;
 	struct drm_event event;
 	struct drm_msm_hist *hist_data;
+	struct sde_cp_hist_ring *ring;
+	struct sde_cp_hist_slot *slot = NULL;
 	struct sde_kms *kms;
 	int ret;
-	u32 i;
+	u32 i, seq = 0;
 
 	if (!crtc_drm) {
 		DRM_ERROR("invalid crtc %pK\n", crtc_drm);
@@ -2467,7 +2504,8 @@ static void sde_cp_notify_hist_event(struct drm_crtc *crtc_drm, void *arg)
 		return;
 	}
 
-	if (!crtc->hist_blob)
+	ring = crtc->hist_ring;
+	if (!crtc->hist_blob && !ring)
 		return;
 
 	kms = get_kms(crtc_drm);
@@ -2483,8 +2521,22 @@ static void sde_cp_notify_hist_event(struct drm_crtc *crtc_drm, void *arg)
 		return;
 	}
 
-	/* read histogram data into blob */
-	hist_data = (struct drm_msm_hist *)crtc->hist_blob->data;
+	/*
+	 * Read straight into the next ring slot when the ring exists. The
+	 * slot seq is cleared first so a reader racing with the update sees
+	 * the slot as invalid rather than a torn frame.
+	 */
+	if (ring) {
+		seq = ring->seq + 1;
+		if (!seq)
+			seq = 1;
+		slot = &ring->slots[seq % SDE_CP_HIST_RING_SLOTS];
+		WRITE_ONCE(slot->seq, 0);
+		smp_wmb();
+		hist_data = &slot->hist;
+	} else {
+		hist_data = (struct drm_msm_hist *)crtc->hist_blob->data;
+	}
 	memset(hist_data->data, 0, sizeof(hist_data->data));
 	for (i = 0; i < crtc->num_mixers; i++) {
 		hw_dspp = crtc->mixers[i].hw_dspp;
@@ -2498,6 +2550,29 @@ static void sde_cp_notify_hist_event(struct drm_crtc *crtc_drm, void *arg)
 	}
 
 	pm_runtime_put_sync(kms->dev->dev);
+
+	if (slot) {
+		slot->timestamp = ktime_to_ns(crtc->hist_irq_time);
+		smp_wmb();
+		WRITE_ONCE(slot->seq, seq);
+		smp_wmb();
+		WRITE_ONCE(ring->seq, seq);
+		if (crtc->hist_event_sf)
+			sysfs_notify_dirent(crtc->hist_event_sf);
+	}
+
+	/*
+	 * The blob event is only for legacy clients: skip the copy and the
+	 * event when the ring reader asked for it or nobody is listening.
+	 */
+	if (!crtc->hist_blob || (slot && READ_ONCE(crtc->hist_ring_only)) ||
+			!msm_mode_object_event_has_client(&crtc_drm->base,
+				crtc_drm->dev, DRM_EVENT_HISTOGRAM))
+		return;
+
+	if (slot)
+		memcpy(crtc->hist_blob->data, hist_data, sizeof(*hist_data));
+
 	/* send histogram event with blob id */
 	event.length = sizeof(u32);
 	event.type = DRM_EVENT_HISTOGRAM;
@@ -2505,6 +2580,59 @@ static void sde_cp_notify_hist_event(struct drm_crtc *crtc_drm, void *arg)
 			&event, (u8 *)(&crtc->hist_blob->base.id));
 }
 
+ssize_t sde_cp_hist_ring_read(struct drm_crtc *crtc_drm, char *buf,
+	loff_t off, size_t count)
+{
+	struct sde_crtc *crtc;
+
+	if (!crtc_drm || !buf) {
+		DRM_ERROR("invalid crtc %pK buf %pK\n", crtc_drm, buf);
+		return -EINVAL;
+	}
+
+	crtc = to_sde_crtc(crtc_drm);
+	if (!crtc->hist_ring)
+		return -ENODEV;
+
+	return memory_read_from_buffer(buf, count, &off, crtc->hist_ring,
+			SDE_CP_HIST_RING_SIZE);
+}
+
+int sde_cp_hist_ring_mmap(struct drm_crtc *crtc_drm,
+	struct vm_area_struct *vma)
+{
+	struct sde_crtc *crtc;
+
+	if (!crtc_drm || !vma) {
+		DRM_ERROR("invalid crtc %pK vma %pK\n", crtc_drm, vma);
+		return -EINVAL;
+	}
+
+	crtc = to_sde_crtc(crtc_drm);
+	if (!crtc->hist_ring)
+		return -ENODEV;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+	vma->vm_flags &= ~VM_MAYWRITE;
+
+	return remap_vmalloc_range(vma, crtc->hist_ring, vma->vm_pgoff);
+}
+
+u32 sde_cp_hist_ring_seq(struct drm_crtc *crtc_drm)
+{
+	struct sde_crtc *crtc;
+
+	if (!crtc_drm)
+		return 0;
+
+	crtc = to_sde_crtc(crtc_drm);
+	if (!crtc->hist_ring)
+		return 0;
+
+	return READ_ONCE(crtc->hist_ring->seq);
+}
+
 int sde_cp_hist_interrupt(struct drm_crtc *crtc_drm, bool en,
 	struct sde_irq_callback *hist_irq)
 {
@@ -5,10 +5,50 @@
 
 #ifndef _SDE_COLOR_PROCESSING_H
 #define _SDE_COLOR_PROCESSING_H
+#include <linux/mm.h>
 #include <drm/drm_crtc.h>
+#include <drm/msm_drm_pp.h>
 
 struct sde_irq_callback;
 
+#define SDE_CP_HIST_RING_VERSION	1
+#define SDE_CP_HIST_RING_SLOTS		8
+
+/**
+ * struct sde_cp_hist_slot - one histogram frame in the shared ring
+ * @seq: sequence number of the frame held in this slot, 0 while the slot
+ *       is being written by the driver
+ * @reserved: padding, must be zero
+ * @timestamp: ktime in ns of the histogram done interrupt for this frame
+ * @hist: histogram bins and status read back from the dspp
+ */
+struct sde_cp_hist_slot {
+	u32 seq;
+	u32 reserved;
+	u64 timestamp;
+	struct drm_msm_hist hist;
+};
+
+/**
+ * struct sde_cp_hist_ring - histogram ring mapped read-only to user space
+ * @version: layout version, SDE_CP_HIST_RING_VERSION
+ * @num_slots: number of entries in @slots
+ * @slot_size: size in bytes of a single slot
+ * @seq: sequence number of the most recently completed frame; the frame
+ *       lives in slots[seq % num_slots]. A reader must re-check the slot
+ *       seq after copying the data to detect an overwrite.
+ * @slots: histogram frames
+ */
+struct sde_cp_hist_ring {
+	u32 version;
+	u32 num_slots;
+	u32 slot_size;
+	u32 seq;
+	struct sde_cp_hist_slot slots[SDE_CP_HIST_RING_SLOTS];
+};
+
+#define SDE_CP_HIST_RING_SIZE	PAGE_ALIGN(sizeof(struct sde_cp_hist_ring))
+
 /*
  * PA MEMORY COLOR types
  * @MEMCOLOR_SKIN          Skin memory color type
@@ -196,4 +236,31 @@ int sde_cp_ltm_off_event_handler(struct drm_crtc *crtc_drm, bool en,
  * @crtc_drm: Pointer to crtc.
  */
 void sde_cp_mode_switch_prop_dirty(struct drm_crtc *crtc_drm);
+
+/**
+ * sde_cp_hist_ring_read: API to copy out part of the histogram ring
+ * @crtc_drm: Pointer to crtc.
+ * @buf: Destination buffer.
+ * @off: Offset into the ring.
+ * @count: Number of bytes requested.
+ * Returns: number of bytes copied or negative error code
+ */
+ssize_t sde_cp_hist_ring_read(struct drm_crtc *crtc_drm, char *buf,
+	loff_t off, size_t count);
+
+/**
+ * sde_cp_hist_ring_mmap: API to map the histogram ring read-only
+ * @crtc_drm: Pointer to crtc.
+ * @vma: User vma to map the ring into.
+ * Returns: 0 on success, negative error code otherwise
+ */
+int sde_cp_hist_ring_mmap(struct drm_crtc *crtc_drm,
+	struct vm_area_struct *vma);
+
+/**
+ * sde_cp_hist_ring_seq: API to get the last completed histogram frame
+ * @crtc_drm: Pointer to crtc.
+ * Returns: sequence number of the last frame, 0 if none
+ */
+u32 sde_cp_hist_ring_seq(struct drm_crtc *crtc_drm);
 #endif /*_SDE_COLOR_PROCESSING_H */
@@ -22,6 +22,14 @@
 /* Autorefresh will occur after FRAME_CNT frames. Large values are unlikely */
 #define AUTOREFRESH_MAX_FRAME_CNT 6
 
+/* consecutive ESD checks that may be skipped on observed panel activity */
+#define ESD_MAX_SKIP_CNT 4
+/* maximum idle backoff multiplier of the ESD interval */
+#define ESD_MAX_BACKOFF 8
+/* checks run at 1/ESD_TIGHT_DIVIDER of the interval after an ESD failure */
+#define ESD_TIGHT_CHECK_CNT 8
+#define ESD_TIGHT_DIVIDER 4
+
 #define SDE_DEBUG_CONN(c, fmt, ...) SDE_DEBUG("conn%d " fmt,\
 		(c) ? (c)->base.base.id : -1, ##__VA_ARGS__)
 
@@ -316,6 +324,58 @@ int sde_connector_get_info(struct drm_connector *connector,
 	return c_conn->ops.get_info(&c_conn->base, info, c_conn->display);
 }
 
+static u32 _sde_connector_esd_interval(struct sde_connector *c_conn)
+{
+	u32 interval;
+
+	/* If debugfs property is not set then take default value */
+	interval = c_conn->esd_status_interval ?
+		c_conn->esd_status_interval : STATUS_CHECK_INTERVAL_MS;
+
+	if (!c_conn->esd_adaptive)
+		return interval;
+
+	/* check more often right after a failure, less often when idle */
+	if (c_conn->esd_tight_cnt)
+		return max_t(u32, interval / ESD_TIGHT_DIVIDER, 1);
+
+	return interval * c_conn->esd_backoff;
+}
+
+/*
+ * _sde_connector_esd_check - run the panel status check and account for
+ *	it in the ESD statistics; caller must hold c_conn->lock
+ */
+static int _sde_connector_esd_check(struct sde_connector *c_conn,
+		bool te_check_override)
+{
+	struct sde_connector_esd_stats *stats = &c_conn->esd_stats;
+	ktime_t start;
+	u64 delta;
+	int rc;
+
+	start = ktime_get();
+	rc = c_conn->ops.check_status(&c_conn->base, c_conn->display,
+			te_check_override);
+	delta = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	stats->performed++;
+	stats->time_ns += delta;
+	stats->max_time_ns = max(stats->max_time_ns, delta);
+
+	if (rc <= 0) {
+		stats->failed++;
+		c_conn->esd_tight_cnt = ESD_TIGHT_CHECK_CNT;
+		c_conn->esd_backoff = 1;
+	} else if (c_conn->esd_tight_cnt) {
+		c_conn->esd_tight_cnt--;
+	}
+
+	SDE_EVT32(c_conn->base.base.id, rc, delta);
+
+	return rc;
+}
+
 void sde_connector_schedule_status_work(struct drm_connector *connector,
 		bool en)
 {
@@ -337,12 +397,16 @@ void sde_connector_schedule_status_work(struct drm_connector *connector,
 			u32 interval;
 
 			/*
-			 * If debugfs property is not set then take
-			 * default value
+			 * TE and frame done only prove the panel is alive
+			 * when the panel drives them, i.e. in command mode
 			 */
-			interval = c_conn->esd_status_interval ?
-				c_conn->esd_status_interval :
-					STATUS_CHECK_INTERVAL_MS;
+			c_conn->esd_activity_valid = !!(info.capabilities &
+					MSM_DISPLAY_CAP_CMD_MODE);
+			c_conn->esd_skip_cnt = 0;
+			c_conn->esd_backoff = 1;
+			c_conn->esd_last_check_ns = ktime_get_ns();
+
+			interval = _sde_connector_esd_interval(c_conn);
 			/* Schedule ESD status check */
 			schedule_delayed_work(&c_conn->status_work,
 				msecs_to_jiffies(interval));
@@ -1816,6 +1880,24 @@ static int sde_connector_init_debugfs(struct drm_connector *connector)
 		debugfs_create_u32("esd_status_interval", 0600,
 				connector->debugfs_entry,
 				&sde_connector->esd_status_interval);
+		debugfs_create_bool("esd_adaptive", 0600,
+				connector->debugfs_entry,
+				&sde_connector->esd_adaptive);
+		debugfs_create_u64("esd_checks_performed", 0400,
+				connector->debugfs_entry,
+				&sde_connector->esd_stats.performed);
+		debugfs_create_u64("esd_checks_skipped", 0400,
+				connector->debugfs_entry,
+				&sde_connector->esd_stats.skipped);
+		debugfs_create_u64("esd_checks_failed", 0400,
+				connector->debugfs_entry,
+				&sde_connector->esd_stats.failed);
+		debugfs_create_u64("esd_check_time_ns", 0400,
+				connector->debugfs_entry,
+				&sde_connector->esd_stats.time_ns);
+		debugfs_create_u64("esd_check_max_time_ns", 0400,
+				connector->debugfs_entry,
+				&sde_connector->esd_stats.max_time_ns);
 	}
 
 	if (!debugfs_create_bool("fb_kmap", 0600, connector->debugfs_entry,
@@ -2083,8 +2165,7 @@ int sde_connector_esd_status(struct drm_connector *conn)
 		mutex_unlock(&sde_conn->lock);
 		return -ETIMEDOUT;
 	}
-	ret = sde_conn->ops.check_status(&sde_conn->base,
-					 sde_conn->display, true);
+	ret = _sde_connector_esd_check(sde_conn, true);
 	mutex_unlock(&sde_conn->lock);
 
 	if (ret <= 0) {
@@ -2106,6 +2187,8 @@ static void sde_connector_check_status_work(struct work_struct *work)
 	struct sde_connector *conn;
 	int rc = 0;
 	struct device *dev;
+	bool alive, adaptive;
+	u64 now;
 
 	conn = container_of(to_delayed_work(work),
 			struct sde_connector, status_work);
@@ -2124,7 +2207,37 @@ static void sde_connector_check_status_work(struct work_struct *work)
 		return;
 	}
 
-	rc = conn->ops.check_status(&conn->base, conn->display, false);
+	now = ktime_get_ns();
+	alive = (u64)atomic64_read(&conn->esd_alive_ns) >
+			conn->esd_last_check_ns;
+	conn->esd_last_check_ns = now;
+	adaptive = conn->esd_adaptive && conn->esd_activity_valid &&
+			!conn->esd_tight_cnt;
+
+	if (adaptive) {
+		if (alive) {
+			conn->esd_backoff = 1;
+			/*
+			 * A panel TE since the last check proves the panel
+			 * is alive; still read its status every few intervals
+			 */
+			if (conn->esd_skip_cnt < ESD_MAX_SKIP_CNT) {
+				conn->esd_skip_cnt++;
+				conn->esd_stats.skipped++;
+				rc = 1;
+				goto unlock;
+			}
+		}
+	}
+
+	conn->esd_skip_cnt = 0;
+	rc = _sde_connector_esd_check(conn, false);
+
+	/* idle since the last check, back off only on a good status read */
+	if (rc > 0 && adaptive && !alive &&
+			conn->esd_backoff < ESD_MAX_BACKOFF)
+		conn->esd_backoff <<= 1;
+unlock:
 	mutex_unlock(&conn->lock);
 
 	if (rc > 0) {
@@ -2133,9 +2246,7 @@ static void sde_connector_check_status_work(struct work_struct *work)
 		SDE_DEBUG("esd check status success conn_id: %d enc_id: %d\n",
 				conn->base.base.id, conn->encoder->base.id);
 
-		/* If debugfs property is not set then take default value */
-		interval = conn->esd_status_interval ?
-			conn->esd_status_interval : STATUS_CHECK_INTERVAL_MS;
+		interval = _sde_connector_esd_interval(conn);
 		schedule_delayed_work(&conn->status_work,
 			msecs_to_jiffies(interval));
 		return;
@@ -2590,6 +2701,9 @@ struct drm_connector *sde_connector_init(struct drm_device *dev,
 
 	INIT_DELAYED_WORK(&c_conn->status_work,
 			sde_connector_check_status_work);
+	c_conn->esd_adaptive = true;
+	c_conn->esd_backoff = 1;
+	atomic64_set(&c_conn->esd_alive_ns, 0);
 
 	return &c_conn->base;
 
@@ -373,6 +373,22 @@ struct sde_connector_evt {
 	void *usr;
 };
 
+/**
+ * struct sde_connector_esd_stats - ESD status check statistics
+ * @performed: number of status checks sent to the panel
+ * @skipped: number of status checks skipped on observed panel activity
+ * @failed: number of status checks that reported a bad panel
+ * @time_ns: total time spent in status checks
+ * @max_time_ns: longest single status check
+ */
+struct sde_connector_esd_stats {
+	u64 performed;
+	u64 skipped;
+	u64 failed;
+	u64 time_ns;
+	u64 max_time_ns;
+};
+
 struct sde_connector_dyn_hdr_metadata {
 	u8 dynamic_hdr_payload[SDE_CONNECTOR_DHDR_MEMPOOL_MAX_SIZE];
 	int dynamic_hdr_payload_size;
@@ -412,6 +428,16 @@ struct sde_connector_dyn_hdr_metadata {
  * @esd_status_interval: variable to change ESD check interval in millisec
  * @panel_dead: Flag to indicate if panel has gone bad
  * @esd_status_check: Flag to indicate if ESD thread is scheduled or not
+ * @esd_adaptive: Flag to enable activity based skipping and adaptive
+ *	intervals for the ESD status check
+ * @esd_activity_valid: Flag to indicate panel activity can be observed
+ *	through TE, i.e. the panel runs in command mode
+ * @esd_alive_ns: ktime in ns of the last TE from the panel
+ * @esd_last_check_ns: ktime in ns at which the ESD work last ran
+ * @esd_skip_cnt: Number of consecutive ESD checks skipped
+ * @esd_backoff: Idle backoff multiplier applied to the ESD interval
+ * @esd_tight_cnt: Number of ESD checks left at the shortened interval
+ * @esd_stats: ESD status check statistics
  * @bl_scale_dirty: Flag to indicate PP BL scale value(s) is changed
  * @bl_scale: BL scale value for ABA feature
  * @bl_scale_sv: BL scale value for sunlight visibility feature
@@ -462,6 +488,14 @@ struct sde_connector {
 	u32 esd_status_interval;
 	bool panel_dead;
 	bool esd_status_check;
+	bool esd_adaptive;
+	bool esd_activity_valid;
+	atomic64_t esd_alive_ns;
+	u64 esd_last_check_ns;
+	u32 esd_skip_cnt;
+	u32 esd_backoff;
+	u32 esd_tight_cnt;
+	struct sde_connector_esd_stats esd_stats;
 
 	bool bl_scale_dirty;
 	u32 bl_scale;
@@ -499,6 +533,19 @@ struct sde_connector {
 #define sde_connector_get_encoder(C) \
 	((C) ? to_sde_connector((C))->encoder : NULL)
 
+/**
+ * sde_connector_esd_mark_alive - record a panel TE so the next ESD status
+ *	check can be skipped; only feed it panel originated events, never
+ *	MDP side interrupts. Safe in irq context
+ * @conn: Pointer to drm connector structure
+ */
+static inline void sde_connector_esd_mark_alive(struct drm_connector *conn)
+{
+	if (conn)
+		atomic64_set(&to_sde_connector(conn)->esd_alive_ns,
+				ktime_get_ns());
+}
+
 /**
  * sde_connector_qsync_updated - indicates if connector updated qsync
  * @C: Pointer to drm connector structure
@@ -20,6 +20,7 @@
 #include <linux/sort.h>
 #include <linux/debugfs.h>
 #include <linux/ktime.h>
+#include <linux/log2.h>
 #include <uapi/drm/sde_drm.h>
 #include <drm/drm_mode.h>
 #include <drm/drm_crtc.h>
@@ -420,7 +421,83 @@ static ssize_t vsync_event_show(struct device *device,
 			ktime_to_ns(sde_crtc->vblank_last_cb_time));
 }
 
+static ssize_t hist_event_show(struct device *device,
+	struct device_attribute *attr, char *buf)
+{
+	struct drm_crtc *crtc;
+
+	if (!device || !buf) {
+		SDE_ERROR("invalid input param(s)\n");
+		return -EAGAIN;
+	}
+
+	crtc = dev_get_drvdata(device);
+	return scnprintf(buf, PAGE_SIZE, "HIST=%u\n",
+			sde_cp_hist_ring_seq(crtc));
+}
+
+static ssize_t hist_ring_only_store(struct device *device,
+	struct device_attribute *attr, const char *buf, size_t count)
+{
+	struct drm_crtc *crtc;
+	bool en;
+	int res;
+
+	if (!device || !buf) {
+		SDE_ERROR("invalid input param(s)\n");
+		return -EAGAIN;
+	}
+
+	crtc = dev_get_drvdata(device);
+	if (!crtc)
+		return -EINVAL;
+
+	res = kstrtobool(buf, &en);
+	if (res < 0)
+		return res;
+
+	WRITE_ONCE(to_sde_crtc(crtc)->hist_ring_only, en);
+
+	return count;
+}
+
+static ssize_t hist_ring_only_show(struct device *device,
+	struct device_attribute *attr, char *buf)
+{
+	struct drm_crtc *crtc;
+
+	if (!device || !buf) {
+		SDE_ERROR("invalid input param(s)\n");
+		return -EAGAIN;
+	}
+
+	crtc = dev_get_drvdata(device);
+	if (!crtc)
+		return -EINVAL;
+
+	return scnprintf(buf, PAGE_SIZE, "%d\n",
+			READ_ONCE(to_sde_crtc(crtc)->hist_ring_only));
+}
+
+static ssize_t hist_ring_read(struct file *file, struct kobject *kobj,
+	struct bin_attribute *attr, char *buf, loff_t off, size_t count)
+{
+	struct drm_crtc *crtc = dev_get_drvdata(kobj_to_dev(kobj));
+
+	return sde_cp_hist_ring_read(crtc, buf, off, count);
+}
+
+static int hist_ring_mmap(struct file *file, struct kobject *kobj,
+	struct bin_attribute *attr, struct vm_area_struct *vma)
+{
+	struct drm_crtc *crtc = dev_get_drvdata(kobj_to_dev(kobj));
+
+	return sde_cp_hist_ring_mmap(crtc, vma);
+}
+
 static DEVICE_ATTR_RO(vsync_event);
+static DEVICE_ATTR_RO(hist_event);
+static DEVICE_ATTR_RW(hist_ring_only);
 static DEVICE_ATTR_RO(measured_fps);
 static DEVICE_ATTR_RW(fps_periodicity_ms);
 static DEVICE_ATTR_WO(early_wakeup);
@@ -430,11 +507,26 @@ static struct attribute *sde_crtc_dev_attrs[] = {
 	&dev_attr_measured_fps.attr,
 	&dev_attr_fps_periodicity_ms.attr,
 	&dev_attr_early_wakeup.attr,
+	&dev_attr_hist_event.attr,
+	&dev_attr_hist_ring_only.attr,
+	NULL
+};
+
+static struct bin_attribute bin_attr_hist_ring = {
+	.attr = { .name = "hist_ring", .mode = 0444 },
+	.size = SDE_CP_HIST_RING_SIZE,
+	.read = hist_ring_read,
+	.mmap = hist_ring_mmap,
+};
+
+static struct bin_attribute *sde_crtc_dev_bin_attrs[] = {
+	&bin_attr_hist_ring,
 	NULL
 };
 
 static const struct attribute_group sde_crtc_attr_group = {
 	.attrs = sde_crtc_dev_attrs,
+	.bin_attrs = sde_crtc_dev_bin_attrs,
 };
 
 static const struct attribute_group *sde_crtc_attr_groups[] = {
@@ -453,6 +545,8 @@ static void sde_crtc_destroy(struct drm_crtc *crtc)
 
 	if (sde_crtc->vsync_event_sf)
 		sysfs_put(sde_crtc->vsync_event_sf);
+	if (sde_crtc->hist_event_sf)
+		sysfs_put(sde_crtc->hist_event_sf);
 	if (sde_crtc->sysfs_dev)
 		device_unregister(sde_crtc->sysfs_dev);
 
@@ -467,6 +561,7 @@ static void sde_crtc_destroy(struct drm_crtc *crtc)
 	drm_crtc_cleanup(crtc);
 	mutex_destroy(&sde_crtc->vblank_modeset_ctrl_lock);
 	mutex_destroy(&sde_crtc->crtc_lock);
+	kfree(sde_crtc->check_memo);
 	kfree(sde_crtc);
 }
 
@@ -3354,6 +3449,12 @@ static void sde_crtc_atomic_flush(struct drm_crtc *crtc,
 		cstate->rsc_update = true;
 	}
 
+	/*
+	 * Plane updates only queue changed OT limits; program them for all
+	 * clients of a vbif at once, ahead of the ctl flush.
+	 */
+	sde_vbif_flush_pending(sde_kms);
+
 	/*
 	 * Final plane updates: Give each plane a chance to complete all
 	 *                      required writes/flushing before crtc's "flush
@@ -3579,6 +3680,87 @@ int sde_crtc_reset_hw(struct drm_crtc *crtc, struct drm_crtc_state *old_state,
 	return !recovery_events ? 0 : -EAGAIN;
 }
 
+static int _sde_crtc_cmp_u32(const void *a, const void *b)
+{
+	u32 x = *(const u32 *)a, y = *(const u32 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*
+ * _sde_crtc_predict_wakeup - learn the commit interval and schedule an early
+ *	wakeup ahead of the next expected commit
+ *
+ * Only intervals long enough for the encoder to drop its resources are worth
+ * predicting. A wakeup is scheduled when the recent intervals agree with their
+ * median within 1/8th, and its outcome is scored on the next commit.
+ */
+static void _sde_crtc_predict_wakeup(struct drm_crtc *crtc)
+{
+	struct sde_crtc *sde_crtc = to_sde_crtc(crtc);
+	struct sde_crtc_wakeup_predictor *wp = &sde_crtc->wakeup_pred;
+	struct msm_drm_private *priv = crtc->dev->dev_private;
+	u32 sorted[SDE_CRTC_PREDICT_HISTORY];
+	u32 predicted_us, tolerance_us, confidence = 0;
+	ktime_t now = ktime_get();
+	unsigned long flags;
+	u64 delta_us;
+	int i;
+
+	spin_lock_irqsave(&wp->lock, flags);
+	if (wp->armed) {
+		if (!wp->fired) {
+			wp->preempted++;
+		} else {
+			delta_us = ktime_us_delta(now, wp->fire_ts);
+			if (delta_us <= 2 * (u64)wp->lead_us)
+				wp->hits++;
+			else
+				wp->misses++;
+		}
+		wp->armed = false;
+	}
+	spin_unlock_irqrestore(&wp->lock, flags);
+
+	if (wp->last_ts) {
+		delta_us = ktime_us_delta(now, wp->last_ts);
+		wp->history[wp->next] = min_t(u64, delta_us, U32_MAX);
+		wp->next = (wp->next + 1) % SDE_CRTC_PREDICT_HISTORY;
+		wp->count = min_t(u32, wp->count + 1,
+				SDE_CRTC_PREDICT_HISTORY);
+	}
+	wp->last_ts = now;
+
+	if (!wp->enable || wp->count < SDE_CRTC_PREDICT_HISTORY ||
+			crtc->index >= ARRAY_SIZE(priv->disp_thread))
+		return;
+
+	memcpy(sorted, wp->history, sizeof(sorted));
+	sort(sorted, SDE_CRTC_PREDICT_HISTORY, sizeof(u32),
+			_sde_crtc_cmp_u32, NULL);
+	predicted_us = sorted[SDE_CRTC_PREDICT_HISTORY / 2];
+	tolerance_us = predicted_us / 8;
+
+	for (i = 0; i < SDE_CRTC_PREDICT_HISTORY; i++)
+		if (abs((s64)wp->history[i] - predicted_us) <= tolerance_us)
+			confidence++;
+
+	if (confidence < wp->min_confidence ||
+			predicted_us <= IDLE_POWERCOLLAPSE_DURATION * USEC_PER_MSEC ||
+			predicted_us <= wp->lead_us)
+		return;
+
+	spin_lock_irqsave(&wp->lock, flags);
+	wp->armed = true;
+	wp->fired = false;
+	wp->predictions++;
+	spin_unlock_irqrestore(&wp->lock, flags);
+	kthread_mod_delayed_work(&priv->disp_thread[crtc->index].worker,
+			&wp->work, usecs_to_jiffies(predicted_us - wp->lead_us));
+
+	SDE_EVT32_VERBOSE(DRMID(crtc), predicted_us, confidence);
+}
+
 void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 		struct drm_crtc_state *old_state)
 {
@@ -3654,6 +3836,7 @@ void sde_crtc_commit_kickoff(struct drm_crtc *crtc,
 	}
 
 	sde_crtc_calc_fps(sde_crtc);
+	_sde_crtc_predict_wakeup(crtc);
 	SDE_ATRACE_BEGIN("flush_event_thread");
 	_sde_crtc_flush_event_thread(crtc);
 	SDE_ATRACE_END("flush_event_thread");
@@ -4015,6 +4198,14 @@ static void sde_crtc_disable(struct drm_crtc *crtc)
 			crtc->state->active, crtc->state->enable);
 	sde_crtc->enabled = false;
 
+	/* commit cadence before disable says nothing about the next enable */
+	kthread_cancel_delayed_work_sync(&sde_crtc->wakeup_pred.work);
+	spin_lock_irqsave(&sde_crtc->wakeup_pred.lock, flags);
+	sde_crtc->wakeup_pred.armed = false;
+	spin_unlock_irqrestore(&sde_crtc->wakeup_pred.lock, flags);
+	sde_crtc->wakeup_pred.last_ts = 0;
+	sde_crtc->wakeup_pred.count = 0;
+
 	/* Try to disable uidle */
 	sde_core_perf_crtc_update_uidle(crtc, false);
 
@@ -4741,6 +4932,276 @@ static int _sde_crtc_atomic_check_pstates(struct drm_crtc *crtc,
 	return 0;
 }
 
+/**
+ * struct sde_crtc_check_plane - plane inputs of the crtc plane validation
+ * @zpos: zpos property
+ * @fb_modifier: framebuffer format modifier
+ * @plane_id: drm plane object id
+ * @pipe_id: sspp backing the plane
+ * @fb_format: framebuffer fourcc
+ * @fb_mode: fb translation mode property
+ * @multirect_mode: multirect mode property
+ * @const_alpha_en: constant alpha state from plane atomic check
+ * @crtc_x: destination x offset
+ * @crtc_y: destination y offset
+ * @crtc_w: destination width
+ * @crtc_h: destination height
+ * @src_x: source x offset, q16
+ * @src_y: source y offset, q16
+ * @src_w: source width, q16
+ * @src_h: source height, q16
+ * @excl_rect: exclusion rectangle
+ */
+struct sde_crtc_check_plane {
+	u64 zpos;
+	u64 fb_modifier;
+	u32 plane_id;
+	u32 pipe_id;
+	u32 fb_format;
+	u32 fb_mode;
+	u32 multirect_mode;
+	u32 const_alpha_en;
+	s32 crtc_x;
+	s32 crtc_y;
+	u32 crtc_w;
+	u32 crtc_h;
+	u32 src_x;
+	u32 src_y;
+	u32 src_w;
+	u32 src_h;
+	struct sde_rect excl_rect;
+};
+
+/**
+ * struct sde_crtc_check_key - inputs of the crtc plane validation
+ *	Zeroed before it is filled so it can be compared with memcmp.
+ * @hdisplay: active width of the adjusted mode
+ * @vdisplay: active height of the adjusted mode
+ * @mixer_width: width of each layer mixer
+ * @mixer_height: height of each layer mixer
+ * @num_ds_enabled: number of enabled destination scalers
+ * @security_level: crtc security level property
+ * @smmu_state: smmu transition state
+ * @secure_level: smmu secure level
+ * @encoder_mask: encoders driven by the crtc
+ * @had_planes: whether the current crtc state has planes staged
+ * @num_conns: number of valid @conn_id entries
+ * @conn_id: connectors of the atomic state attached to the crtc
+ * @conn_fb_mode: fb translation mode property of each connector
+ * @num_dim_layers: number of valid @dim_layer entries
+ * @dim_layer: dim layer configuration
+ * @cnt: number of valid @planes entries
+ * @planes: plane inputs, in plane index order
+ */
+struct sde_crtc_check_key {
+	u32 hdisplay;
+	u32 vdisplay;
+	u32 mixer_width;
+	u32 mixer_height;
+	u32 num_ds_enabled;
+	u32 security_level;
+	u32 smmu_state;
+	u32 secure_level;
+	u32 encoder_mask;
+	u32 had_planes;
+	u32 num_conns;
+	u32 conn_id[MAX_CONNECTORS];
+	u32 conn_fb_mode[MAX_CONNECTORS];
+	u32 num_dim_layers;
+	struct sde_hw_dim_layer dim_layer[SDE_MAX_DIM_LAYERS];
+	u32 cnt;
+	struct sde_crtc_check_plane planes[SDE_PSTATES_MAX];
+};
+
+/**
+ * struct sde_crtc_check_result - per plane output of the plane validation
+ * @stage: blend stage assigned from zpos
+ * @multirect_index: multirect rectangle index
+ * @multirect_mode: multirect fetch mode
+ * @const_alpha_en: constant alpha state after multirect validation
+ */
+struct sde_crtc_check_result {
+	u32 stage;
+	u32 multirect_index;
+	u32 multirect_mode;
+	bool const_alpha_en;
+};
+
+/**
+ * struct sde_crtc_check_memo - last successful crtc plane validation
+ * @valid: whether @key and @result describe a passed validation
+ * @key: inputs of the validation
+ * @result: per plane outputs of the validation, indexed like @key.planes
+ */
+struct sde_crtc_check_memo {
+	bool valid;
+	struct sde_crtc_check_key key;
+	struct sde_crtc_check_result result[SDE_PSTATES_MAX];
+};
+
+/**
+ * _sde_crtc_check_memo_key - collect the inputs of the plane validation
+ * @crtc: Pointer to drm crtc structure
+ * @state: Pointer to drm crtc state being validated
+ * @key: Pointer to key to fill
+ * Return: true if the key fully describes the state
+ */
+static bool _sde_crtc_check_memo_key(struct drm_crtc *crtc,
+		struct drm_crtc_state *state, struct sde_crtc_check_key *key)
+{
+	struct sde_crtc *sde_crtc = to_sde_crtc(crtc);
+	struct sde_crtc_state *cstate = to_sde_crtc_state(state);
+	struct sde_kms *kms = _sde_crtc_get_kms(crtc);
+	struct drm_connector *conn;
+	struct drm_connector_state *conn_state;
+	struct drm_plane *plane;
+	const struct drm_plane_state *pstate;
+	struct sde_plane_state *sde_pstate;
+	struct sde_crtc_check_plane *p;
+	int i;
+
+	if (!kms)
+		return false;
+
+	memset(key, 0, sizeof(*key));
+
+	key->hdisplay = state->adjusted_mode.hdisplay;
+	key->vdisplay = state->adjusted_mode.vdisplay;
+	key->mixer_width = sde_crtc_get_mixer_width(sde_crtc, cstate,
+			&state->adjusted_mode);
+	key->mixer_height = sde_crtc_get_mixer_height(sde_crtc, cstate,
+			&state->adjusted_mode);
+	key->num_ds_enabled = cstate->num_ds_enabled;
+	key->security_level = sde_crtc_get_property(cstate,
+			CRTC_PROP_SECURITY_LEVEL);
+	key->smmu_state = kms->smmu_state.state;
+	key->secure_level = kms->smmu_state.secure_level;
+	key->encoder_mask = state->encoder_mask;
+	key->had_planes = crtc->state && crtc->state->plane_mask;
+
+	for_each_new_connector_in_state(state->state, conn, conn_state, i) {
+		if (!conn_state || conn_state->crtc != crtc)
+			continue;
+		if (key->num_conns >= MAX_CONNECTORS)
+			return false;
+
+		key->conn_id[key->num_conns] = conn->base.id;
+		key->conn_fb_mode[key->num_conns] =
+			sde_connector_get_property(conn_state,
+				CONNECTOR_PROP_FB_TRANSLATION_MODE);
+		key->num_conns++;
+	}
+
+	key->num_dim_layers = min_t(u32, cstate->num_dim_layers,
+			SDE_MAX_DIM_LAYERS);
+	memcpy(key->dim_layer, cstate->dim_layer,
+			key->num_dim_layers * sizeof(key->dim_layer[0]));
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		if (IS_ERR_OR_NULL(pstate) || !pstate->fb ||
+				key->cnt >= SDE_PSTATES_MAX)
+			return false;
+
+		sde_pstate = to_sde_plane_state(pstate);
+		p = &key->planes[key->cnt++];
+
+		p->zpos = sde_plane_get_property(sde_pstate, PLANE_PROP_ZPOS);
+		p->fb_modifier = pstate->fb->modifier;
+		p->plane_id = plane->base.id;
+		p->pipe_id = sde_plane_pipe(plane);
+		p->fb_format = pstate->fb->format->format;
+		p->fb_mode = sde_plane_get_property(sde_pstate,
+				PLANE_PROP_FB_TRANSLATION_MODE);
+		p->multirect_mode = sde_plane_get_property(sde_pstate,
+				PLANE_PROP_MULTIRECT_MODE);
+		p->const_alpha_en = sde_pstate->const_alpha_en;
+		p->crtc_x = pstate->crtc_x;
+		p->crtc_y = pstate->crtc_y;
+		p->crtc_w = pstate->crtc_w;
+		p->crtc_h = pstate->crtc_h;
+		p->src_x = pstate->src_x;
+		p->src_y = pstate->src_y;
+		p->src_w = pstate->src_w;
+		p->src_h = pstate->src_h;
+		p->excl_rect = sde_pstate->excl_rect;
+	}
+
+	return true;
+}
+
+/**
+ * _sde_crtc_check_memo_apply - restore the memoized plane validation
+ *	The plane states of @state must match the memo key, so they are
+ *	visited in the same order the key was built.
+ * @memo: Pointer to valid memo
+ * @state: Pointer to drm crtc state being validated
+ */
+static void _sde_crtc_check_memo_apply(struct sde_crtc_check_memo *memo,
+		struct drm_crtc_state *state)
+{
+	struct drm_plane *plane;
+	const struct drm_plane_state *pstate;
+	struct sde_plane_state *sde_pstate;
+	struct sde_crtc_check_result *res;
+	int i = 0;
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		sde_pstate = to_sde_plane_state(pstate);
+		res = &memo->result[i++];
+
+		sde_pstate->stage = res->stage;
+		sde_pstate->multirect_index = res->multirect_index;
+		sde_pstate->multirect_mode = res->multirect_mode;
+		sde_pstate->const_alpha_en = res->const_alpha_en;
+	}
+}
+
+/**
+ * _sde_crtc_check_memo_store - remember a successful plane validation
+ * @memo: Pointer to memo
+ * @key: Pointer to key the validation was run for
+ * @state: Pointer to validated drm crtc state
+ */
+static void _sde_crtc_check_memo_store(struct sde_crtc_check_memo *memo,
+		struct sde_crtc_check_key *key, struct drm_crtc_state *state)
+{
+	struct drm_plane *plane;
+	const struct drm_plane_state *pstate;
+	struct sde_plane_state *sde_pstate;
+	struct sde_crtc_check_result *res;
+	int i = 0;
+
+	memcpy(&memo->key, key, sizeof(*key));
+
+	drm_atomic_crtc_state_for_each_plane_state(plane, pstate, state) {
+		sde_pstate = to_sde_plane_state(pstate);
+		res = &memo->result[i++];
+
+		res->stage = sde_pstate->stage;
+		res->multirect_index = sde_pstate->multirect_index;
+		res->multirect_mode = sde_pstate->multirect_mode;
+		res->const_alpha_en = sde_pstate->const_alpha_en;
+	}
+
+	memo->valid = true;
+}
+
+/**
+ * _sde_crtc_check_update_stats - account the duration of an atomic check
+ * @sde_crtc: Pointer to sde crtc structure
+ * @start: ktime at which the check started
+ */
+static void _sde_crtc_check_update_stats(struct sde_crtc *sde_crtc,
+		ktime_t start)
+{
+	struct sde_crtc_check_stats *stats = &sde_crtc->check_stats;
+	u64 us = ktime_us_delta(ktime_get(), start);
+
+	stats->last_us = us;
+	stats->max_us = max(stats->max_us, us);
+	stats->total_us += us;
+}
+
 static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 		struct drm_crtc_state *state)
 {
@@ -4751,8 +5212,12 @@ static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 	struct drm_display_mode *mode;
 	int rc = 0;
 	struct sde_multirect_plane_states *multirect_plane = NULL;
+	struct sde_crtc_check_key *key = NULL;
+	struct sde_crtc_check_memo *memo;
 	struct drm_connector *conn;
 	struct drm_connector_list_iter conn_iter;
+	bool use_memo;
+	ktime_t start;
 
 	if (!crtc) {
 		SDE_ERROR("invalid crtc\n");
@@ -4762,13 +5227,21 @@ static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 	dev = crtc->dev;
 	sde_crtc = to_sde_crtc(crtc);
 	cstate = to_sde_crtc_state(state);
+	start = ktime_get();
 
 	if (!state->enable || !state->active) {
 		SDE_DEBUG("crtc%d -> enable %d, active %d, skip atomic_check\n",
 				crtc->base.id, state->enable, state->active);
+		if (sde_crtc->check_memo)
+			sde_crtc->check_memo->valid = false;
 		goto end;
 	}
 
+	if (!sde_crtc->check_memo)
+		sde_crtc->check_memo = kzalloc(sizeof(*sde_crtc->check_memo),
+				GFP_KERNEL);
+	memo = sde_crtc->check_memo;
+
 	pstates = kcalloc(SDE_PSTATES_MAX,
 			sizeof(struct plane_state), GFP_KERNEL);
 
@@ -4776,6 +5249,9 @@ static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 			sizeof(struct sde_multirect_plane_states),
 			GFP_KERNEL);
 
+	if (memo)
+		key = kmalloc(sizeof(*key), GFP_KERNEL);
+
 	if (!pstates || !multirect_plane) {
 		rc = -ENOMEM;
 		goto end;
@@ -4809,11 +5285,32 @@ static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 	_sde_crtc_setup_is_ppsplit(state);
 	_sde_crtc_setup_lm_bounds(crtc, state);
 
-	rc = _sde_crtc_atomic_check_pstates(crtc, state, pstates,
-			multirect_plane);
-	if (rc) {
-		SDE_ERROR("crtc%d failed pstate check %d\n", crtc->base.id, rc);
-		goto end;
+	/*
+	 * Plane validation only depends on the inputs gathered in the key;
+	 * reuse the last verdict and its stage/multirect assignment when
+	 * none of them changed. A modeset always revalidates.
+	 */
+	use_memo = key && !drm_atomic_crtc_needs_modeset(state) &&
+			_sde_crtc_check_memo_key(crtc, state, key);
+
+	if (use_memo && memo->valid && !memcmp(&memo->key, key, sizeof(*key))) {
+		_sde_crtc_check_memo_apply(memo, state);
+		sde_crtc->check_stats.hits++;
+	} else {
+		if (memo)
+			memo->valid = false;
+		sde_crtc->check_stats.misses++;
+
+		rc = _sde_crtc_atomic_check_pstates(crtc, state, pstates,
+				multirect_plane);
+		if (rc) {
+			SDE_ERROR("crtc%d failed pstate check %d\n",
+					crtc->base.id, rc);
+			goto end;
+		}
+
+		if (use_memo)
+			_sde_crtc_check_memo_store(memo, key, state);
 	}
 
 	rc = sde_core_perf_crtc_check(crtc, state);
@@ -4830,8 +5327,10 @@ static int sde_crtc_atomic_check(struct drm_crtc *crtc,
 	}
 
 end:
+	kfree(key);
 	kfree(pstates);
 	kfree(multirect_plane);
+	_sde_crtc_check_update_stats(sde_crtc, start);
 	return rc;
 }
 
@@ -5858,6 +6357,35 @@ static int sde_crtc_debugfs_state_show(struct seq_file *s, void *v)
 }
 DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_crtc_debugfs_state);
 
+static int sde_crtc_debugfs_event_rings_show(struct seq_file *s, void *v)
+{
+	struct sde_crtc *sde_crtc = s->private;
+	struct sde_crtc_event_ring *ring;
+	static const char * const names[SDE_CRTC_EVENT_RING_MAX] = {
+		[SDE_CRTC_EVENT_RING_CRTC] = "crtc",
+		[SDE_CRTC_EVENT_RING_PP] = "pp",
+	};
+	u32 ran;
+	int i;
+
+	for (i = 0; i < SDE_CRTC_EVENT_RING_MAX; i++) {
+		ring = &sde_crtc->event_rings[i];
+		ran = READ_ONCE(ring->tail);
+
+		seq_printf(s, "%s: queued:%u pending:%u coalesced:%u dropped:%u batches:%u\n",
+				names[i], ring->queued,
+				atomic_read(&ring->head) - ran,
+				ring->coalesced, ring->dropped,
+				ring->batches);
+		seq_printf(s, "%s: latency_max_us:%u latency_avg_us:%llu\n",
+				names[i], ring->latency_max_us,
+				ran ? div_u64(ring->latency_total_us, ran) : 0);
+	}
+
+	return 0;
+}
+DEFINE_SDE_DEBUGFS_SEQ_FOPS(sde_crtc_debugfs_event_rings);
+
 static int _sde_debugfs_fence_status_show(struct seq_file *s, void *data)
 {
 	struct drm_crtc *crtc;
@@ -5981,6 +6509,33 @@ static int _sde_crtc_init_debugfs(struct drm_crtc *crtc)
 					sde_crtc, &debugfs_fps_fops);
 	debugfs_create_file("fence_status", 0400, sde_crtc->debugfs_root,
 					sde_crtc, &debugfs_fence_fops);
+	debugfs_create_file("event_rings", 0400, sde_crtc->debugfs_root,
+					sde_crtc, &sde_crtc_debugfs_event_rings_fops);
+	debugfs_create_u64("check_memo_hits", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->check_stats.hits);
+	debugfs_create_u64("check_memo_misses", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->check_stats.misses);
+	debugfs_create_u64("check_last_us", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->check_stats.last_us);
+	debugfs_create_u64("check_max_us", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->check_stats.max_us);
+	debugfs_create_u64("check_total_us", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->check_stats.total_us);
+	debugfs_create_bool("predict_wakeup", 0600, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.enable);
+	debugfs_create_u32("predict_lead_us", 0600, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.lead_us);
+	debugfs_create_u32("predict_min_confidence", 0600,
+			sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.min_confidence);
+	debugfs_create_u32("predict_count", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.predictions);
+	debugfs_create_u32("predict_hits", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.hits);
+	debugfs_create_u32("predict_misses", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.misses);
+	debugfs_create_u32("predict_preempted", 0400, sde_crtc->debugfs_root,
+			&sde_crtc->wakeup_pred.preempted);
 
 	return 0;
 }
@@ -6037,100 +6592,199 @@ static const struct drm_crtc_helper_funcs sde_crtc_helper_funcs = {
 	.atomic_flush = sde_crtc_atomic_flush,
 };
 
-static void _sde_crtc_event_cb(struct kthread_work *work)
+static void _sde_crtc_event_drain_work(struct kthread_work *work)
 {
+	struct sde_crtc_event_ring *ring;
 	struct sde_crtc_event *event;
 	struct sde_crtc *sde_crtc;
-	unsigned long irq_flags;
+	void (*cb_func)(struct drm_crtc *crtc, void *usr);
+	void *usr;
+	ktime_t ts;
+	u32 latency;
 
 	if (!work) {
 		SDE_ERROR("invalid work item\n");
 		return;
 	}
 
-	event = container_of(work, struct sde_crtc_event, kt_work);
+	ring = container_of(work, struct sde_crtc_event_ring, drain_work);
+	sde_crtc = ring->sde_crtc;
 
-	/* set sde_crtc to NULL for static work structures */
-	sde_crtc = event->sde_crtc;
-	if (!sde_crtc)
-		return;
+	/*
+	 * Re-arm before draining, an event published from here on either
+	 * is seen by the loop below or queues this work again.
+	 */
+	atomic_xchg(&ring->drain_pending, 0);
+	ring->batches++;
+
+	for (;;) {
+		event = &ring->slots[ring->tail & (SDE_CRTC_MAX_EVENT_COUNT - 1)];
+		if (atomic_read_acquire(&event->seq) != ring->tail + 1)
+			break;
+
+		cb_func = event->cb_func;
+		usr = event->usr;
+		ts = event->ts;
+
+		/*
+		 * Hand the slot back before running the callback, so that a
+		 * producer only coalesces into events whose callback has not
+		 * started yet.
+		 */
+		atomic_set_release(&event->seq,
+				ring->tail + SDE_CRTC_MAX_EVENT_COUNT);
+		ring->tail++;
+		smp_mb();
+
+		latency = (u32)ktime_us_delta(ktime_get(), ts);
+		ring->latency_total_us += latency;
+		if (latency > ring->latency_max_us)
+			ring->latency_max_us = latency;
+
+		if (cb_func)
+			cb_func(&sde_crtc->base, usr);
+	}
+}
+
+/**
+ * _sde_crtc_event_coalesce - look for an identical published event
+ * @ring: Pointer to event ring
+ * @func: Callback function of the new event
+ * @usr: User data of the new event
+ * Returns: True if an identical event is pending and has not started
+ */
+static bool _sde_crtc_event_coalesce(struct sde_crtc_event_ring *ring,
+		void (*func)(struct drm_crtc *crtc, void *usr), void *usr)
+{
+	struct sde_crtc_event *event;
+	u32 i, seq;
+	bool match;
+
+	/* order the caller's data updates before the slot checks */
+	smp_mb();
 
-	if (event->cb_func)
-		event->cb_func(&sde_crtc->base, event->usr);
+	for (i = 0; i < SDE_CRTC_MAX_EVENT_COUNT; i++) {
+		event = &ring->slots[i];
+		seq = atomic_read_acquire(&event->seq);
 
-	spin_lock_irqsave(&sde_crtc->event_lock, irq_flags);
-	list_add_tail(&event->list, &sde_crtc->event_free_list);
-	spin_unlock_irqrestore(&sde_crtc->event_lock, irq_flags);
+		/* published slots hold seq == position + 1 */
+		if (((seq - 1) & (SDE_CRTC_MAX_EVENT_COUNT - 1)) != i)
+			continue;
+
+		match = READ_ONCE(event->cb_func) == func &&
+			READ_ONCE(event->usr) == usr;
+
+		/* the slot must not have been recycled while reading it */
+		smp_rmb();
+		if (match && atomic_read(&event->seq) == seq)
+			return true;
+	}
+
+	return false;
 }
 
 int sde_crtc_event_queue(struct drm_crtc *crtc,
 		void (*func)(struct drm_crtc *crtc, void *usr),
 		void *usr, bool color_processing_event)
 {
-	unsigned long irq_flags;
 	struct sde_crtc *sde_crtc;
-	struct msm_drm_private *priv;
-	struct sde_crtc_event *event = NULL;
-	u32 crtc_id;
+	struct sde_crtc_event_ring *ring;
+	struct sde_crtc_event *event;
+	u32 pos, seq, prev;
 
 	if (!crtc || !crtc->dev || !crtc->dev->dev_private || !func) {
 		SDE_ERROR("invalid parameters\n");
 		return -EINVAL;
 	}
 	sde_crtc = to_sde_crtc(crtc);
-	priv = crtc->dev->dev_private;
-	crtc_id = drm_crtc_index(crtc);
+	ring = &sde_crtc->event_rings[color_processing_event ?
+			SDE_CRTC_EVENT_RING_PP : SDE_CRTC_EVENT_RING_CRTC];
+
+	if (_sde_crtc_event_coalesce(ring, func, usr)) {
+		ring->coalesced++;
+		return 0;
+	}
 
 	/*
-	 * Obtain an event struct from the private cache. This event
-	 * queue may be called from ISR contexts, so use a private
-	 * cache to avoid calling any memory allocation functions.
+	 * Reserve a slot without locking. This event queue may be called
+	 * from ISR contexts on several cpus; a slot is free for position pos
+	 * once its sequence equals pos.
 	 */
-	spin_lock_irqsave(&sde_crtc->event_lock, irq_flags);
-	if (!list_empty(&sde_crtc->event_free_list)) {
-		event = list_first_entry(&sde_crtc->event_free_list,
-				struct sde_crtc_event, list);
-		list_del_init(&event->list);
+	pos = atomic_read(&ring->head);
+	for (;;) {
+		event = &ring->slots[pos & (SDE_CRTC_MAX_EVENT_COUNT - 1)];
+		seq = atomic_read_acquire(&event->seq);
+
+		if (seq == pos) {
+			prev = atomic_cmpxchg(&ring->head, pos, pos + 1);
+			if (prev == pos)
+				break;
+			pos = prev;
+		} else if ((s32)(seq - pos) < 0) {
+			ring->dropped++;
+			SDE_EVT32(DRMID(crtc), color_processing_event,
+					ring->dropped, SDE_EVTLOG_ERROR);
+			return -ENOMEM;
+		} else {
+			pos = atomic_read(&ring->head);
+		}
 	}
-	spin_unlock_irqrestore(&sde_crtc->event_lock, irq_flags);
 
-	if (!event)
-		return -ENOMEM;
-
-	/* populate event node */
-	event->sde_crtc = sde_crtc;
+	/* populate and publish event slot */
 	event->cb_func = func;
 	event->usr = usr;
+	event->ts = ktime_get();
+	atomic_set_release(&event->seq, pos + 1);
+	ring->queued++;
 
-	/* queue new event request */
-	kthread_init_work(&event->kt_work, _sde_crtc_event_cb);
-	if (color_processing_event)
-		kthread_queue_work(&priv->pp_event_worker,
-			&event->kt_work);
-	else
-		kthread_queue_work(&priv->event_thread[crtc_id].worker,
-			&event->kt_work);
+	/* one worker wakeup per batch of published events */
+	if (!atomic_xchg(&ring->drain_pending, 1))
+		kthread_queue_work(ring->worker, &ring->drain_work);
 
 	return 0;
 }
 
 static int _sde_crtc_init_events(struct sde_crtc *sde_crtc)
 {
-	int i, rc = 0;
+	struct msm_drm_private *priv;
+	struct sde_crtc_event_ring *ring;
+	int i, j;
 
-	if (!sde_crtc) {
+	if (!sde_crtc || !sde_crtc->base.dev ||
+			!sde_crtc->base.dev->dev_private) {
 		SDE_ERROR("invalid crtc\n");
 		return -EINVAL;
 	}
 
-	spin_lock_init(&sde_crtc->event_lock);
+	priv = sde_crtc->base.dev->dev_private;
+	if (drm_crtc_index(&sde_crtc->base) >= ARRAY_SIZE(priv->event_thread)) {
+		SDE_ERROR("invalid crtc index %u\n",
+				drm_crtc_index(&sde_crtc->base));
+		return -EINVAL;
+	}
+
+	BUILD_BUG_ON(!is_power_of_2(SDE_CRTC_MAX_EVENT_COUNT));
 
-	INIT_LIST_HEAD(&sde_crtc->event_free_list);
-	for (i = 0; i < SDE_CRTC_MAX_EVENT_COUNT; ++i)
-		list_add_tail(&sde_crtc->event_cache[i].list,
-				&sde_crtc->event_free_list);
+	for (i = 0; i < SDE_CRTC_EVENT_RING_MAX; i++) {
+		ring = &sde_crtc->event_rings[i];
 
-	return rc;
+		for (j = 0; j < SDE_CRTC_MAX_EVENT_COUNT; j++)
+			atomic_set(&ring->slots[j].seq, j);
+
+		atomic_set(&ring->head, 0);
+		ring->tail = 0;
+		atomic_set(&ring->drain_pending, 0);
+		ring->sde_crtc = sde_crtc;
+		kthread_init_work(&ring->drain_work,
+				_sde_crtc_event_drain_work);
+	}
+
+	sde_crtc->event_rings[SDE_CRTC_EVENT_RING_CRTC].worker =
+		&priv->event_thread[drm_crtc_index(&sde_crtc->base)].worker;
+	sde_crtc->event_rings[SDE_CRTC_EVENT_RING_PP].worker =
+		&priv->pp_event_worker;
+
+	return 0;
 }
 
 /*
@@ -6191,6 +6845,32 @@ static void __sde_crtc_early_wakeup_work(struct kthread_work *work)
 	sde_kms_trigger_early_wakeup(sde_kms, crtc);
 }
 
+/*
+ * __sde_crtc_predict_wakeup_work - trigger early wakeup ahead of the commit
+ *	expected by the wakeup predictor
+ */
+static void __sde_crtc_predict_wakeup_work(struct kthread_work *work)
+{
+	struct sde_crtc_wakeup_predictor *wp = container_of(work,
+			struct sde_crtc_wakeup_predictor, work.work);
+	struct sde_crtc *sde_crtc = container_of(wp, struct sde_crtc,
+			wakeup_pred);
+	unsigned long flags;
+
+	spin_lock_irqsave(&wp->lock, flags);
+	if (!wp->armed || wp->fired) {
+		spin_unlock_irqrestore(&wp->lock, flags);
+		return;
+	}
+
+	wp->fired = true;
+	wp->fire_ts = ktime_get();
+	spin_unlock_irqrestore(&wp->lock, flags);
+	SDE_EVT32(DRMID(&sde_crtc->base), wp->predictions);
+
+	__sde_crtc_early_wakeup_work(&sde_crtc->early_wakeup_work);
+}
+
 /* initialize crtc */
 struct drm_crtc *sde_crtc_init(struct drm_device *dev, struct drm_plane *plane)
 {
@@ -6284,6 +6964,12 @@ struct drm_crtc *sde_crtc_init(struct drm_device *dev, struct drm_plane *plane)
 					__sde_crtc_idle_notify_work);
 	kthread_init_work(&sde_crtc->early_wakeup_work,
 					__sde_crtc_early_wakeup_work);
+	kthread_init_delayed_work(&sde_crtc->wakeup_pred.work,
+					__sde_crtc_predict_wakeup_work);
+	spin_lock_init(&sde_crtc->wakeup_pred.lock);
+	sde_crtc->wakeup_pred.enable = false;
+	sde_crtc->wakeup_pred.lead_us = 8000;
+	sde_crtc->wakeup_pred.min_confidence = 6;
 
 	SDE_DEBUG("crtc=%d new_llcc=%d, old_llcc=%d\n",
 		crtc->base.id,
@@ -6325,6 +7011,12 @@ int sde_crtc_post_init(struct drm_device *dev, struct drm_crtc *crtc)
 		SDE_ERROR("crtc:%d vsync_event sysfs create failed\n",
 						crtc->base.id);
 
+	sde_crtc->hist_event_sf = sysfs_get_dirent(
+		sde_crtc->sysfs_dev->kobj.sd, "hist_event");
+	if (!sde_crtc->hist_event_sf)
+		SDE_ERROR("crtc:%d hist_event sysfs create failed\n",
+						crtc->base.id);
+
 end:
 	return rc;
 }
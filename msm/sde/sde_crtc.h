@@ -35,6 +35,24 @@
 /* Expand it to 2x for handling atleast 2 connectors safely */
 #define SDE_CRTC_FRAME_EVENT_SIZE	(4 * 2)
 
+struct sde_crtc_check_memo;
+
+/**
+ * struct sde_crtc_check_stats - atomic check timing
+ * @hits: checks that reused the memoized plane validation verdict
+ * @misses: checks that ran the full plane validation
+ * @last_us: duration of the last atomic check
+ * @max_us: longest atomic check
+ * @total_us: accumulated atomic check time
+ */
+struct sde_crtc_check_stats {
+	u64 hits;
+	u64 misses;
+	u64 last_us;
+	u64 max_us;
+	u64 total_us;
+};
+
 /**
  * enum sde_crtc_client_type: crtc client type
  * @RT_CLIENT:	RealTime client like video/cmd mode display
@@ -128,21 +146,73 @@ struct sde_crtc_frame_event {
 	u32 event;
 };
 
+/*
+ * Number of event slots per event ring, must be a power of two
+ */
+#define SDE_CRTC_MAX_EVENT_COUNT	16
+
 /**
- * struct sde_crtc_event - event callback tracking structure
- * @list:     Linked list tracking node
- * @kt_work:  Kthread worker structure
- * @sde_crtc: Pointer to associated sde_crtc structure
+ * enum sde_crtc_event_ring_id - destination worker of a crtc event
+ * @SDE_CRTC_EVENT_RING_CRTC: crtc event thread
+ * @SDE_CRTC_EVENT_RING_PP:   color processing event worker
+ * @SDE_CRTC_EVENT_RING_MAX:  number of event rings
+ */
+enum sde_crtc_event_ring_id {
+	SDE_CRTC_EVENT_RING_CRTC,
+	SDE_CRTC_EVENT_RING_PP,
+	SDE_CRTC_EVENT_RING_MAX
+};
+
+/**
+ * struct sde_crtc_event - event callback slot
+ * @seq:      Slot sequence, equals the ring position the slot is free for,
+ *            or that position + 1 once the event is published
  * @cb_func:  Pointer to callback function
  * @usr:      Pointer to user data to be provided to the callback
+ * @ts:       Time the event was queued
  */
 struct sde_crtc_event {
-	struct list_head list;
-	struct kthread_work kt_work;
-	void *sde_crtc;
-
+	atomic_t seq;
 	void (*cb_func)(struct drm_crtc *crtc, void *usr);
 	void *usr;
+	ktime_t ts;
+};
+
+/**
+ * struct sde_crtc_event_ring - lock-free multi-producer single-consumer
+ *	queue of crtc event callbacks
+ * @slots:      Event slots
+ * @head:       Next ring position reserved by a producer
+ * @tail:       Next ring position to run, owned by @drain_work
+ * @drain_pending: Set while @drain_work is queued and not yet draining
+ * @drain_work: Kthread work running every published event
+ * @worker:     Kthread worker executing @drain_work
+ * @sde_crtc:   Pointer to owning sde_crtc structure
+ * @queued:     Number of events published to the ring
+ * @coalesced:  Number of events merged into an identical pending event
+ * @dropped:    Number of events rejected because the ring was full
+ * @batches:    Number of @drain_work runs
+ * @latency_max_us: Longest queue to run latency in usec
+ * @latency_total_us: Sum of queue to run latencies in usec
+ *
+ * Producers may run in interrupt context on any cpu and only use atomic
+ * operations on @head and the slot sequences; the counters are updated
+ * racily and are for debugging only.
+ */
+struct sde_crtc_event_ring {
+	struct sde_crtc_event slots[SDE_CRTC_MAX_EVENT_COUNT];
+	atomic_t head;
+	u32 tail;
+	atomic_t drain_pending;
+	struct kthread_work drain_work;
+	struct kthread_worker *worker;
+	struct sde_crtc *sde_crtc;
+	u32 queued;
+	u32 coalesced;
+	u32 dropped;
+	u32 batches;
+	u32 latency_max_us;
+	u64 latency_total_us;
 };
 /**
  * struct sde_crtc_fps_info - structure for measuring fps periodicity
@@ -164,6 +234,53 @@ struct sde_crtc_fps_info {
 	u32 next_time_index;
 };
 
+#define SDE_CRTC_PREDICT_HISTORY	8
+
+/**
+ * struct sde_crtc_wakeup_predictor - early wakeup from commit history
+ * @work: delayed work issuing the predicted early wakeup
+ * @lock: protects @armed, @fired, @fire_ts and the outcome counters
+ * @last_ts: time of the previous commit, 0 if none
+ * @history: recent inter-commit intervals in us
+ * @next: next slot of @history to fill
+ * @count: number of valid entries in @history
+ * @armed: a wakeup is scheduled or issued for the next commit
+ * @fired: the scheduled wakeup was issued
+ * @fire_ts: time the wakeup was issued
+ * @enable: predictor enabled, off by default, controlled through the
+ *	predict_wakeup debugfs node
+ * @lead_us: how long before the predicted commit to wake up
+ * @min_confidence: intervals of @history that have to agree with the
+ *	median before a wakeup is scheduled
+ * @predictions: number of scheduled wakeups
+ * @hits: issued wakeups followed by a commit within twice @lead_us
+ * @misses: issued wakeups followed by a later commit
+ * @preempted: scheduled wakeups overtaken by a commit
+ *
+ * The history is only updated on kickoff and disable of the crtc, which
+ * are serialized by the commit. @work runs on the crtc display thread, but
+ * the kickoff of a multi-crtc commit runs on the display thread of the
+ * first crtc, so the state shared with @work is guarded by @lock.
+ */
+struct sde_crtc_wakeup_predictor {
+	struct kthread_delayed_work work;
+	spinlock_t lock;
+	ktime_t last_ts;
+	u32 history[SDE_CRTC_PREDICT_HISTORY];
+	u32 next;
+	u32 count;
+	bool armed;
+	bool fired;
+	ktime_t fire_ts;
+	bool enable;
+	u32 lead_us;
+	u32 min_confidence;
+	u32 predictions;
+	u32 hits;
+	u32 misses;
+	u32 preempted;
+};
+
 /**
  * struct sde_ltm_buffer - defines LTM buffer structure.
  * @fb: frm framebuffer for the buffer
@@ -196,11 +313,6 @@ struct sde_crtc_misr_info {
 	u32 misr_frame_count;
 };
 
-/*
- * Maximum number of free event structures to cache
- */
-#define SDE_CRTC_MAX_EVENT_COUNT	16
-
 /**
  * struct sde_crtc - virtualized CRTC data structure
  * @base          : Base drm crtc structure
@@ -226,6 +338,7 @@ struct sde_crtc_misr_info {
  * @vblank_last_cb_time  : ktime at last vblank notification
  * @sysfs_dev  : sysfs device node for crtc
  * @vsync_event_sf : vsync event notifier sysfs device
+ * @hist_event_sf : histogram frame notifier sysfs device
  * @enabled       : whether the SDE CRTC is currently enabled. updated in the
  *                  commit-thread, not state-swap time which is earlier, so
  *                  safe to make decisions on during VBLANK on/off work
@@ -244,9 +357,7 @@ struct sde_crtc_misr_info {
  * @spin_lock     : spin lock for frame event, transaction status, etc...
  * @event_thread  : Pointer to event handler thread
  * @event_worker  : Event worker queue
- * @event_cache   : Local cache of event worker structures
- * @event_free_list : List of available event structures
- * @event_lock    : Spinlock around event handling code
+ * @event_rings   : Event callback rings, one per destination worker
  * @misr_enable_sui : boolean entry indicates misr enable/disable status
  *                    for secure cases.
  * @misr_enable_debugfs : boolean entry indicates misr enable/disable status
@@ -255,6 +366,7 @@ struct sde_crtc_misr_info {
  * @misr_data     : store misr data before turning off the clocks.
  * @idle_notify_work: delayed worker to notify idle timeout to user space
  * @early_wakeup_work: work to trigger early wakeup
+ * @wakeup_pred   : predictor issuing early wakeups from commit history
  * @power_event   : registered power event handle
  * @cur_perf      : current performance committed to clock/bandwidth driver
  * @plane_mask_old: keeps track of the planes used in the previous commit
@@ -268,6 +380,8 @@ struct sde_crtc_misr_info {
  * @ltm_lock        : Spinlock to protect ltm buffer_cnt, hist_en and ltm lists
  * @needs_hw_reset  : Initiate a hw ctl reset
  * @comp_ratio      : Compression ratio
+ * @check_memo      : last successful plane validation of atomic check
+ * @check_stats     : atomic check memo hit counts and timing
  */
 struct sde_crtc {
 	struct drm_crtc base;
@@ -300,6 +414,7 @@ struct sde_crtc {
 	struct sde_crtc_fps_info fps_info;
 	struct device *sysfs_dev;
 	struct kernfs_node *vsync_event_sf;
+	struct kernfs_node *hist_event_sf;
 	bool enabled;
 
 	bool ds_reconfig;
@@ -320,14 +435,13 @@ struct sde_crtc {
 	spinlock_t spin_lock;
 
 	/* for handling internal event thread */
-	struct sde_crtc_event event_cache[SDE_CRTC_MAX_EVENT_COUNT];
-	struct list_head event_free_list;
-	spinlock_t event_lock;
+	struct sde_crtc_event_ring event_rings[SDE_CRTC_EVENT_RING_MAX];
 	bool misr_enable_sui;
 	bool misr_enable_debugfs;
 	u32 misr_frame_count;
 	struct kthread_delayed_work idle_notify_work;
 	struct kthread_work early_wakeup_work;
+	struct sde_crtc_wakeup_predictor wakeup_pred;
 
 	struct sde_power_event *power_event;
 
@@ -338,6 +452,11 @@ struct sde_crtc {
 
 	/* blob for histogram data */
 	struct drm_property_blob *hist_blob;
+	/* user mappable ring of histogram frames */
+	struct sde_cp_hist_ring *hist_ring;
+	/* ring reader is in use, skip the legacy histogram blob event */
+	bool hist_ring_only;
+	ktime_t hist_irq_time;
 	enum frame_trigger_mode_type frame_trigger_mode;
 
 	u32 ltm_buffer_cnt;
@@ -351,6 +470,9 @@ struct sde_crtc {
 	bool needs_hw_reset;
 
 	int comp_ratio;
+
+	struct sde_crtc_check_memo *check_memo;
+	struct sde_crtc_check_stats check_stats;
 };
 
 #define to_sde_crtc(x) container_of(x, struct sde_crtc, base)
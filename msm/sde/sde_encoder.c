@@ -154,13 +154,56 @@ enum sde_enc_rc_events {
  * @SDE_ENC_RC_STATE_ON: Resource is in ON state
  * @SDE_ENC_RC_STATE_MODESET: Resource is in modeset state
  * @SDE_ENC_RC_STATE_IDLE: Resource is in IDLE state
+ * @SDE_ENC_RC_STATE_MAX: Number of resource control states
  */
 enum sde_enc_rc_states {
 	SDE_ENC_RC_STATE_OFF,
 	SDE_ENC_RC_STATE_PRE_OFF,
 	SDE_ENC_RC_STATE_ON,
 	SDE_ENC_RC_STATE_MODESET,
-	SDE_ENC_RC_STATE_IDLE
+	SDE_ENC_RC_STATE_IDLE,
+	SDE_ENC_RC_STATE_MAX
+};
+
+/*
+ * enum sde_enc_rc_wakeup - transitions to ON whose latency is tracked
+ * @SDE_ENC_RC_WAKEUP_KICKOFF_IDLE: IDLE to ON on kickoff
+ * @SDE_ENC_RC_WAKEUP_KICKOFF_OFF: OFF to ON on kickoff
+ * @SDE_ENC_RC_WAKEUP_EARLY: IDLE to ON on early wakeup
+ * @SDE_ENC_RC_WAKEUP_MAX: Number of tracked transitions
+ */
+enum sde_enc_rc_wakeup {
+	SDE_ENC_RC_WAKEUP_KICKOFF_IDLE,
+	SDE_ENC_RC_WAKEUP_KICKOFF_OFF,
+	SDE_ENC_RC_WAKEUP_EARLY,
+	SDE_ENC_RC_WAKEUP_MAX
+};
+
+/* bucket n counts samples in [2^(n-1), 2^n) units, the last one is open */
+#define SDE_ENC_RC_HIST_BUCKETS		16
+
+/**
+ * struct sde_enc_rc_stats - resource control residency and wakeup telemetry
+ * @state_ts:		time the current state was entered, 0 if never
+ * @entries:		number of times each state was entered
+ * @residency_us:	total time spent in each state
+ * @residency_hist:	log2 histogram of each stay in a state, in ms
+ * @transitions:	transition counts, indexed by [from][to]
+ * @wakeup_count:	number of tracked wakeups of each kind
+ * @wakeup_last_us:	latest latency of each wakeup kind
+ * @wakeup_max_us:	largest latency of each wakeup kind
+ * @wakeup_hist:	log2 histogram of each wakeup kind, in us
+ */
+struct sde_enc_rc_stats {
+	ktime_t state_ts;
+	u32 entries[SDE_ENC_RC_STATE_MAX];
+	u64 residency_us[SDE_ENC_RC_STATE_MAX];
+	u32 residency_hist[SDE_ENC_RC_STATE_MAX][SDE_ENC_RC_HIST_BUCKETS];
+	u32 transitions[SDE_ENC_RC_STATE_MAX][SDE_ENC_RC_STATE_MAX];
+	u32 wakeup_count[SDE_ENC_RC_WAKEUP_MAX];
+	u64 wakeup_last_us[SDE_ENC_RC_WAKEUP_MAX];
+	u64 wakeup_max_us[SDE_ENC_RC_WAKEUP_MAX];
+	u32 wakeup_hist[SDE_ENC_RC_WAKEUP_MAX][SDE_ENC_RC_HIST_BUCKETS];
 };
 
 /**
@@ -212,6 +255,8 @@ enum sde_enc_rc_states {
  * @rc_lock:			resource control mutex lock to protect
  *				virt encoder over various state changes
  * @rc_state:			resource controller state
+ * @rc_stats:			resource controller state residency and wakeup
+ *				latency telemetry, protected by rc_lock
  * @delayed_off_work:		delayed worker to schedule disabling of
  *				clks and resources after IDLE_TIMEOUT time.
  * @vsync_event_work:		worker to handle vsync event for autorefresh
@@ -279,6 +324,7 @@ struct sde_encoder_virt {
 	bool idle_pc_enabled;
 	struct mutex rc_lock;
 	enum sde_enc_rc_states rc_state;
+	struct sde_enc_rc_stats rc_stats;
 	struct kthread_delayed_work delayed_off_work;
 	struct kthread_work vsync_event_work;
 	struct kthread_work input_event_work;
@@ -2350,11 +2396,60 @@ static void sde_encoder_idle_hint(const struct drm_encoder *drm_enc,
 	SDE_ATRACE_END(__func__);
 }
 
+static inline int _sde_encoder_rc_hist_bucket(u64 val)
+{
+	return min_t(int, fls64(val), SDE_ENC_RC_HIST_BUCKETS - 1);
+}
+
+/*
+ * _sde_encoder_rc_set_state - move the resource control to a new state and
+ *	account the time spent in the previous one. Caller holds rc_lock.
+ */
+static void _sde_encoder_rc_set_state(struct sde_encoder_virt *sde_enc,
+		enum sde_enc_rc_states state)
+{
+	struct sde_enc_rc_stats *stats = &sde_enc->rc_stats;
+	enum sde_enc_rc_states old = sde_enc->rc_state;
+	ktime_t now = ktime_get();
+	u64 us;
+
+	if (stats->state_ts) {
+		us = ktime_us_delta(now, stats->state_ts);
+		stats->residency_us[old] += us;
+		stats->residency_hist[old][_sde_encoder_rc_hist_bucket(
+				div_u64(us, USEC_PER_MSEC))]++;
+	}
+
+	stats->transitions[old][state]++;
+	stats->entries[state]++;
+	stats->state_ts = now;
+
+	sde_enc->rc_state = state;
+}
+
+/*
+ * _sde_encoder_rc_record_wakeup - record how long it took to bring the
+ *	resources back on, measured from @start. Caller holds rc_lock.
+ */
+static void _sde_encoder_rc_record_wakeup(struct sde_encoder_virt *sde_enc,
+		enum sde_enc_rc_wakeup kind, ktime_t start)
+{
+	struct sde_enc_rc_stats *stats = &sde_enc->rc_stats;
+	u64 us = ktime_us_delta(ktime_get(), start);
+
+	stats->wakeup_count[kind]++;
+	stats->wakeup_last_us[kind] = us;
+	stats->wakeup_max_us[kind] = max(stats->wakeup_max_us[kind], us);
+	stats->wakeup_hist[kind][_sde_encoder_rc_hist_bucket(us)]++;
+}
+
 static int _sde_encoder_rc_kickoff(struct drm_encoder *drm_enc,
 	u32 sw_event, struct sde_encoder_virt *sde_enc, bool is_vid_mode)
 {
 	struct msm_drm_private *priv;
 	struct sde_kms *sde_kms;
+	enum sde_enc_rc_wakeup wakeup;
+	ktime_t start;
 	int ret = 0;
 
 	priv = drm_enc->dev->dev_private;
@@ -2383,6 +2478,11 @@ static int _sde_encoder_rc_kickoff(struct drm_encoder *drm_enc,
 		goto end;
 	}
 
+	start = ktime_get();
+	wakeup = sde_enc->rc_state == SDE_ENC_RC_STATE_IDLE ?
+			SDE_ENC_RC_WAKEUP_KICKOFF_IDLE :
+			SDE_ENC_RC_WAKEUP_KICKOFF_OFF;
+
 	if (is_vid_mode && sde_enc->rc_state == SDE_ENC_RC_STATE_IDLE) {
 		_sde_encoder_irq_control(drm_enc, true);
 		sde_kms_update_pm_qos_irq_request(sde_kms, true, false);
@@ -2406,7 +2506,8 @@ static int _sde_encoder_rc_kickoff(struct drm_encoder *drm_enc,
 	}
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 			SDE_ENC_RC_STATE_ON, SDE_EVTLOG_FUNC_CASE1);
-	sde_enc->rc_state = SDE_ENC_RC_STATE_ON;
+	_sde_encoder_rc_record_wakeup(sde_enc, wakeup, start);
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_ON);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2524,7 +2625,7 @@ static int _sde_encoder_rc_pre_stop(struct drm_encoder *drm_enc,
 			SDE_ENC_RC_STATE_PRE_OFF,
 			SDE_EVTLOG_FUNC_CASE3);
 
-	sde_enc->rc_state = SDE_ENC_RC_STATE_PRE_OFF;
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_PRE_OFF);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2569,7 +2670,7 @@ static int _sde_encoder_rc_stop(struct drm_encoder *drm_enc,
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 			SDE_ENC_RC_STATE_OFF, SDE_EVTLOG_FUNC_CASE4);
 
-	sde_enc->rc_state = SDE_ENC_RC_STATE_OFF;
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_OFF);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2610,7 +2711,7 @@ static int _sde_encoder_rc_pre_modeset(struct drm_encoder *drm_enc,
 
 		SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 			SDE_ENC_RC_STATE_ON, SDE_EVTLOG_FUNC_CASE5);
-		sde_enc->rc_state = SDE_ENC_RC_STATE_ON;
+		_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_ON);
 	}
 
 	ret = sde_encoder_wait_for_event(drm_enc, MSM_ENC_TX_COMPLETE);
@@ -2630,7 +2731,7 @@ static int _sde_encoder_rc_pre_modeset(struct drm_encoder *drm_enc,
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 		SDE_ENC_RC_STATE_MODESET, SDE_EVTLOG_FUNC_CASE5);
 
-	sde_enc->rc_state = SDE_ENC_RC_STATE_MODESET;
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_MODESET);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2668,7 +2769,7 @@ static int _sde_encoder_rc_post_modeset(struct drm_encoder *drm_enc,
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 			SDE_ENC_RC_STATE_ON, SDE_EVTLOG_FUNC_CASE6);
 
-	sde_enc->rc_state = SDE_ENC_RC_STATE_ON;
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_ON);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2719,7 +2820,7 @@ static int _sde_encoder_rc_idle(struct drm_encoder *drm_enc,
 
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
 			SDE_ENC_RC_STATE_IDLE, SDE_EVTLOG_FUNC_CASE7);
-	sde_enc->rc_state = SDE_ENC_RC_STATE_IDLE;
+	_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_IDLE);
 
 end:
 	mutex_unlock(&sde_enc->rc_lock);
@@ -2732,6 +2833,7 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 {
 	bool autorefresh_enabled = false;
 	struct msm_drm_thread *disp_thread;
+	ktime_t start;
 	int ret = 0;
 
 	if (!sde_enc->crtc ||
@@ -2766,6 +2868,8 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 					msecs_to_jiffies(
 					IDLE_POWERCOLLAPSE_DURATION));
 	} else if (sde_enc->rc_state == SDE_ENC_RC_STATE_IDLE) {
+		start = ktime_get();
+
 		/* enable all the clks and resources */
 		ret = _sde_encoder_resource_control_helper(drm_enc,
 				true);
@@ -2795,7 +2899,9 @@ static int _sde_encoder_rc_early_wakeup(struct drm_encoder *drm_enc,
 				msecs_to_jiffies(
 				IDLE_POWERCOLLAPSE_IN_EARLY_WAKEUP));
 
-		sde_enc->rc_state = SDE_ENC_RC_STATE_ON;
+		_sde_encoder_rc_record_wakeup(sde_enc,
+				SDE_ENC_RC_WAKEUP_EARLY, start);
+		_sde_encoder_rc_set_state(sde_enc, SDE_ENC_RC_STATE_ON);
 	}
 
 	SDE_EVT32(DRMID(drm_enc), sw_event, sde_enc->rc_state,
@@ -5192,6 +5298,89 @@ static int _sde_encoder_debugfs_status_open(struct inode *inode,
 	return single_open(file, _sde_encoder_status_show, inode->i_private);
 }
 
+static const char * const sde_enc_rc_state_names[SDE_ENC_RC_STATE_MAX] = {
+	[SDE_ENC_RC_STATE_OFF] = "off",
+	[SDE_ENC_RC_STATE_PRE_OFF] = "pre_off",
+	[SDE_ENC_RC_STATE_ON] = "on",
+	[SDE_ENC_RC_STATE_MODESET] = "modeset",
+	[SDE_ENC_RC_STATE_IDLE] = "idle",
+};
+
+static const char * const sde_enc_rc_wakeup_names[SDE_ENC_RC_WAKEUP_MAX] = {
+	[SDE_ENC_RC_WAKEUP_KICKOFF_IDLE] = "kickoff_from_idle",
+	[SDE_ENC_RC_WAKEUP_KICKOFF_OFF] = "kickoff_from_off",
+	[SDE_ENC_RC_WAKEUP_EARLY] = "early_wakeup",
+};
+
+static void _sde_encoder_rc_hist_show(struct seq_file *s, const u32 *hist,
+		const char *unit)
+{
+	int i;
+
+	for (i = 0; i < SDE_ENC_RC_HIST_BUCKETS; i++) {
+		if (!hist[i])
+			continue;
+
+		if (i < SDE_ENC_RC_HIST_BUCKETS - 1)
+			seq_printf(s, "    <%lu%s: %u\n", BIT(i), unit, hist[i]);
+		else
+			seq_printf(s, "    >=%lu%s: %u\n", BIT(i - 1), unit,
+					hist[i]);
+	}
+}
+
+static int _sde_encoder_rc_stats_show(struct seq_file *s, void *data)
+{
+	struct sde_encoder_virt *sde_enc;
+	struct sde_enc_rc_stats *stats;
+	u64 residency;
+	int i, j;
+
+	if (!s || !s->private)
+		return -EINVAL;
+
+	sde_enc = s->private;
+	stats = &sde_enc->rc_stats;
+
+	mutex_lock(&sde_enc->rc_lock);
+	seq_printf(s, "state: %s\n", sde_enc_rc_state_names[sde_enc->rc_state]);
+
+	for (i = 0; i < SDE_ENC_RC_STATE_MAX; i++) {
+		residency = stats->residency_us[i];
+		if (i == sde_enc->rc_state && stats->state_ts)
+			residency += ktime_us_delta(ktime_get(), stats->state_ts);
+
+		seq_printf(s, "%s: entries:%u residency:%lluus\n",
+				sde_enc_rc_state_names[i], stats->entries[i],
+				residency);
+		_sde_encoder_rc_hist_show(s, stats->residency_hist[i], "ms");
+
+		for (j = 0; j < SDE_ENC_RC_STATE_MAX; j++)
+			if (stats->transitions[i][j])
+				seq_printf(s, "    -> %s: %u\n",
+						sde_enc_rc_state_names[j],
+						stats->transitions[i][j]);
+	}
+
+	for (i = 0; i < SDE_ENC_RC_WAKEUP_MAX; i++) {
+		seq_printf(s, "%s: count:%u last:%lluus max:%lluus\n",
+				sde_enc_rc_wakeup_names[i],
+				stats->wakeup_count[i],
+				stats->wakeup_last_us[i],
+				stats->wakeup_max_us[i]);
+		_sde_encoder_rc_hist_show(s, stats->wakeup_hist[i], "us");
+	}
+	mutex_unlock(&sde_enc->rc_lock);
+
+	return 0;
+}
+
+static int _sde_encoder_debugfs_rc_stats_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _sde_encoder_rc_stats_show, inode->i_private);
+}
+
 static ssize_t _sde_encoder_misr_setup(struct file *file,
 		const char __user *user_buf, size_t count, loff_t *ppos)
 {
@@ -5337,6 +5526,13 @@ static int _sde_encoder_init_debugfs(struct drm_encoder *drm_enc)
 		.release =	single_release,
 	};
 
+	static const struct file_operations debugfs_rc_stats_fops = {
+		.open =		_sde_encoder_debugfs_rc_stats_open,
+		.read =		seq_read,
+		.llseek =	seq_lseek,
+		.release =	single_release,
+	};
+
 	static const struct file_operations debugfs_misr_fops = {
 		.open = simple_open,
 		.read = _sde_encoder_misr_read,
@@ -5369,6 +5565,9 @@ static int _sde_encoder_init_debugfs(struct drm_encoder *drm_enc)
 	debugfs_create_file("misr_data", 0600,
 		sde_enc->debugfs_root, sde_enc, &debugfs_misr_fops);
 
+	debugfs_create_file("rc_stats", 0400,
+		sde_enc->debugfs_root, sde_enc, &debugfs_rc_stats_fops);
+
 	debugfs_create_bool("idle_power_collapse", 0600, sde_enc->debugfs_root,
 			&sde_enc->idle_pc_enabled);
 
@@ -26,6 +26,11 @@
 #define KICKOFF_TIMEOUT_JIFFIES		msecs_to_jiffies(KICKOFF_TIMEOUT_MS)
 
 #define MAX_TE_PROFILE_COUNT		5
+
+/* writeback output buffers kept mapped after completion */
+#define SDE_WB_MAX_RETIRED_FB		4
+#define SDE_WB_DEFAULT_RETIRE_DEPTH	2
+
 /**
  * enum sde_enc_split_role - Role this physical encoder will play in a
  *	split-panel configuration, where one panel is master, and others slaves.
@@ -385,6 +390,7 @@ struct sde_encoder_phys_cmd_te_timestamp {
  * @wr_ptr_wait_success: log wr_ptr_wait success for release fence trigger
  * @te_timestamp_list: List head for the TE timestamp list
  * @te_timestamp: Array of size MAX_TE_PROFILE_COUNT te_timestamp_list elements
+ * @vsync_from_wd: read pointer is driven by the MDP watchdog, not panel TE
  */
 struct sde_encoder_phys_cmd {
 	struct sde_encoder_phys base;
@@ -397,6 +403,19 @@ struct sde_encoder_phys_cmd {
 	struct list_head te_timestamp_list;
 	struct sde_encoder_phys_cmd_te_timestamp
 			te_timestamp[MAX_TE_PROFILE_COUNT];
+	bool vsync_from_wd;
+};
+
+/**
+ * struct sde_encoder_phys_wb_buf - writeback output buffer pending cleanup
+ * @fb:		Pointer to writeback framebuffer, holds a reference
+ * @aspace:	Address space the framebuffer is mapped in
+ * @kickoff:	Kickoff count at the time the buffer was retired
+ */
+struct sde_encoder_phys_wb_buf {
+	struct drm_framebuffer *fb;
+	struct msm_gem_address_space *aspace;
+	u32 kickoff;
 };
 
 /**
@@ -412,8 +431,14 @@ struct sde_encoder_phys_cmd {
  * @wb_fmt:		Writeback pixel format
  * @wb_fb:		Pointer to current writeback framebuffer
  * @wb_aspace:		Pointer to current writeback address space
- * @cwb_old_fb:		Pointer to old writeback framebuffer
- * @cwb_old_aspace:	Pointer to old writeback address space
+ * @retired:		Ring of output framebuffers whose writeback was issued
+ *			but whose mapping has not been released yet
+ * @retired_head:	Index of the oldest entry in @retired
+ * @retired_cnt:	Number of valid entries in @retired
+ * @retire_depth:	Number of completed output framebuffers kept mapped
+ *			so that a recycled buffer does not need a new mapping
+ * @fb_reuse_count:	Kickoffs whose output buffer was still mapped
+ * @wb_time_max:	Longest kickoff to writeback done time in usec
  * @frame_count:	Counter of completed writeback operations
  * @kickoff_count:	Counter of issued writeback operations
  * @aspace:		address space identifier for non-secure/secure domain
@@ -435,8 +460,12 @@ struct sde_encoder_phys_wb {
 	const struct sde_format *wb_fmt;
 	struct drm_framebuffer *wb_fb;
 	struct msm_gem_address_space *wb_aspace;
-	struct drm_framebuffer *cwb_old_fb;
-	struct msm_gem_address_space *cwb_old_aspace;
+	struct sde_encoder_phys_wb_buf retired[SDE_WB_MAX_RETIRED_FB];
+	u32 retired_head;
+	u32 retired_cnt;
+	u32 retire_depth;
+	u32 fb_reuse_count;
+	u32 wb_time_max;
 	u32 frame_count;
 	u32 kickoff_count;
 	struct msm_gem_address_space *aspace[SDE_IOMMU_DOMAIN_MAX];
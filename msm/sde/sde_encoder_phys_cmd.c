@@ -243,6 +243,10 @@ static void sde_encoder_phys_cmd_te_rd_ptr_irq(void *arg, int irq_idx)
 	cmd_enc = to_sde_encoder_phys_cmd(phys_enc);
 	ctl = phys_enc->hw_ctl;
 
+	/* only a read pointer driven by the panel TE proves it is alive */
+	if (!READ_ONCE(cmd_enc->vsync_from_wd))
+		sde_connector_esd_mark_alive(phys_enc->connector);
+
 	if (ctl && ctl->ops.get_scheduler_status)
 		scheduler_status = ctl->ops.get_scheduler_status(ctl);
 
@@ -1900,6 +1904,10 @@ static void sde_encoder_phys_cmd_setup_vsync_source(
 	if (!phys_enc || !phys_enc->hw_intf)
 		return;
 
+	WRITE_ONCE(to_sde_encoder_phys_cmd(phys_enc)->vsync_from_wd,
+			vsync_source >= SDE_VSYNC_SOURCE_WD_TIMER_4 &&
+			vsync_source <= SDE_VSYNC_SOURCE_WD_TIMER_0);
+
 	sde_encoder_helper_vsync_config(phys_enc, vsync_source, is_dummy);
 
 	if (phys_enc->has_intf_te && phys_enc->hw_intf->ops.vsync_sel)
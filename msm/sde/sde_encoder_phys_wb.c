@@ -297,6 +297,86 @@ void sde_encoder_phys_setup_cdm(struct sde_encoder_phys *phys_enc,
 	}
 }
 
+/**
+ * _sde_encoder_phys_wb_release_fbs - unmap and drop retired output buffers
+ * @wb_enc:	Pointer to writeback encoder
+ * @keep:	Number of most recent buffers to leave mapped
+ */
+static void _sde_encoder_phys_wb_release_fbs(struct sde_encoder_phys_wb *wb_enc,
+		u32 keep)
+{
+	struct sde_encoder_phys_wb_buf *buf;
+
+	while (wb_enc->retired_cnt > keep) {
+		buf = &wb_enc->retired[wb_enc->retired_head];
+
+		SDE_EVT32(DRMID(wb_enc->base.parent), WBID(wb_enc),
+				buf->fb->base.id, buf->kickoff,
+				wb_enc->retired_cnt);
+		msm_framebuffer_cleanup(buf->fb, buf->aspace);
+		drm_framebuffer_put(buf->fb);
+		memset(buf, 0, sizeof(*buf));
+
+		wb_enc->retired_head = (wb_enc->retired_head + 1) %
+				SDE_WB_MAX_RETIRED_FB;
+		wb_enc->retired_cnt--;
+	}
+}
+
+/**
+ * _sde_encoder_phys_wb_retire_fb - hand the current output buffer over to
+ *	the retired ring
+ * @wb_enc:	Pointer to writeback encoder
+ *
+ * The buffer keeps its mapping and reference until it ages out of the ring,
+ * so an output buffer recycled by the client within a few frames is mapped
+ * again by reference count only and cleanup stays off the commit path.
+ */
+static void _sde_encoder_phys_wb_retire_fb(struct sde_encoder_phys_wb *wb_enc)
+{
+	struct sde_encoder_phys_wb_buf *buf;
+
+	if (!wb_enc->wb_fb || !wb_enc->wb_aspace)
+		return;
+
+	if (wb_enc->retired_cnt == SDE_WB_MAX_RETIRED_FB)
+		_sde_encoder_phys_wb_release_fbs(wb_enc,
+				SDE_WB_MAX_RETIRED_FB - 1);
+
+	buf = &wb_enc->retired[(wb_enc->retired_head + wb_enc->retired_cnt) %
+			SDE_WB_MAX_RETIRED_FB];
+	buf->fb = wb_enc->wb_fb;
+	buf->aspace = wb_enc->wb_aspace;
+	buf->kickoff = wb_enc->kickoff_count;
+	wb_enc->retired_cnt++;
+
+	wb_enc->wb_fb = NULL;
+	wb_enc->wb_aspace = NULL;
+}
+
+/**
+ * _sde_encoder_phys_wb_fb_is_mapped - check for a retired mapping of a buffer
+ * @wb_enc:	Pointer to writeback encoder
+ * @fb:		Pointer to output framebuffer
+ * @aspace:	Address space the framebuffer is about to be mapped in
+ */
+static bool _sde_encoder_phys_wb_fb_is_mapped(
+		struct sde_encoder_phys_wb *wb_enc, struct drm_framebuffer *fb,
+		struct msm_gem_address_space *aspace)
+{
+	struct sde_encoder_phys_wb_buf *buf;
+	u32 i;
+
+	for (i = 0; i < wb_enc->retired_cnt; i++) {
+		buf = &wb_enc->retired[(wb_enc->retired_head + i) %
+				SDE_WB_MAX_RETIRED_FB];
+		if (buf->fb == fb && buf->aspace == aspace)
+			return true;
+	}
+
+	return false;
+}
+
 /**
  * sde_encoder_phys_wb_setup_fb - setup output framebuffer
  * @phys_enc:	Pointer to physical encoder
@@ -343,6 +423,9 @@ static void sde_encoder_phys_wb_setup_fb(struct sde_encoder_phys *phys_enc,
 
 	SDE_DEBUG("[fb_secure:%d]\n", wb_cfg->is_secure);
 
+	if (_sde_encoder_phys_wb_fb_is_mapped(wb_enc, fb, aspace))
+		wb_enc->fb_reuse_count++;
+
 	ret = msm_framebuffer_prepare(fb, aspace);
 	if (ret) {
 		SDE_ERROR("prep fb failed, %d\n", ret);
@@ -1242,13 +1325,8 @@ static int _sde_encoder_phys_wb_wait_for_commit_done(
 		event = sde_encoder_phys_wb_frame_timeout(phys_enc);
 	}
 
-	/* cleanup writeback framebuffer */
-	if (wb_enc->wb_fb && wb_enc->wb_aspace) {
-		msm_framebuffer_cleanup(wb_enc->wb_fb, wb_enc->wb_aspace);
-		drm_framebuffer_put(wb_enc->wb_fb);
-		wb_enc->wb_fb = NULL;
-		wb_enc->wb_aspace = NULL;
-	}
+	/* writeback framebuffer is idle, defer its cleanup */
+	_sde_encoder_phys_wb_retire_fb(wb_enc);
 
 skip_wait:
 	/* remove vote for iommu/clk/bus */
@@ -1259,15 +1337,17 @@ skip_wait:
 		wb_time = (u64)ktime_to_us(wb_enc->end_time) -
 				(u64)ktime_to_us(wb_enc->start_time);
 		SDE_DEBUG("wb:%d took %llu us\n", WBID(wb_enc), wb_time);
+		if (wb_time > wb_enc->wb_time_max)
+			wb_enc->wb_time_max = (u32)wb_time;
 	}
 
-	/* cleanup previous buffer if pending */
-	if (wb_enc->cwb_old_fb && wb_enc->cwb_old_aspace) {
-		msm_framebuffer_cleanup(wb_enc->cwb_old_fb, wb_enc->cwb_old_aspace);
-		drm_framebuffer_put(wb_enc->cwb_old_fb);
-		wb_enc->cwb_old_fb = NULL;
-		wb_enc->cwb_old_aspace = NULL;
-	}
+	/*
+	 * Every buffer in the retired ring is idle by now, a clone mode frame
+	 * still in flight is tracked by wb_fb until its own wait. Drop all
+	 * mappings on disable or timeout.
+	 */
+	_sde_encoder_phys_wb_release_fbs(wb_enc, (is_disable || rc) ? 0 :
+			min_t(u32, wb_enc->retire_depth, SDE_WB_MAX_RETIRED_FB));
 
 	SDE_EVT32(DRMID(phys_enc->parent), WBID(wb_enc), wb_enc->frame_count,
 			wb_time, event, rc);
@@ -1327,10 +1407,8 @@ static int sde_encoder_phys_wb_prepare_for_kickoff(
 	SDE_DEBUG("[wb:%d,%u]\n", wb_enc->hw_wb->idx - WB_0,
 			wb_enc->kickoff_count);
 
-	if (phys_enc->in_clone_mode) {
-		wb_enc->cwb_old_fb = wb_enc->wb_fb;
-		wb_enc->cwb_old_aspace = wb_enc->wb_aspace;
-	}
+	if (phys_enc->in_clone_mode)
+		_sde_encoder_phys_wb_retire_fb(wb_enc);
 
 	wb_enc->kickoff_count++;
 
@@ -1625,6 +1703,8 @@ exit:
 		wb_enc->frame_count = wb_enc->kickoff_count;
 	}
 
+	_sde_encoder_phys_wb_release_fbs(wb_enc, 0);
+
 	phys_enc->enable_state = SDE_ENC_DISABLED;
 	wb_enc->crtc = NULL;
 	phys_enc->hw_cdm = NULL;
@@ -1689,6 +1769,13 @@ static int sde_encoder_phys_wb_init_debugfs(
 		return -ENOMEM;
 	}
 
+	debugfs_create_u32("retire_depth", 0600, debugfs_root,
+			&wb_enc->retire_depth);
+	debugfs_create_u32("fb_reuse_count", 0400, debugfs_root,
+			&wb_enc->fb_reuse_count);
+	debugfs_create_u32("wb_time_max_us", 0600, debugfs_root,
+			&wb_enc->wb_time_max);
+
 	return 0;
 }
 #else
@@ -1776,6 +1863,7 @@ struct sde_encoder_phys *sde_encoder_phys_wb_init(
 		goto fail_alloc;
 	}
 	wb_enc->wbdone_timeout = KICKOFF_TIMEOUT_MS;
+	wb_enc->retire_depth = SDE_WB_DEFAULT_RETIRE_DEPTH;
 
 	phys_enc = &wb_enc->base;
 
@@ -178,6 +178,30 @@ static struct dma_fence_ops sde_fence_ops = {
 	.timeline_value_str = sde_fence_timeline_value_str,
 };
 
+/**
+ * _sde_fence_list_insert - add fence to the context list in seqno order
+ * Fences are mostly created in timeline order, so the walk from the tail
+ * normally ends at the first entry.
+ * @ctx: fence context
+ * @sde_fence: fence to add
+ */
+static void _sde_fence_list_insert(struct sde_fence_context *ctx,
+		struct sde_fence *sde_fence)
+{
+	struct sde_fence *fc;
+	struct list_head *pos = &ctx->fence_list_head;
+
+	spin_lock(&ctx->list_lock);
+	list_for_each_entry_reverse(fc, &ctx->fence_list_head, fence_list) {
+		if ((int)(fc->base.seqno - sde_fence->base.seqno) <= 0) {
+			pos = &fc->fence_list;
+			break;
+		}
+	}
+	list_add(&sde_fence->fence_list, pos);
+	spin_unlock(&ctx->list_lock);
+}
+
 /**
  * _sde_fence_create_fd - create fence object and return an fd for it
  * This function is NOT thread-safe.
@@ -230,9 +254,7 @@ static int _sde_fence_create_fd(void *fence_ctx, uint32_t val)
 	fd_install(fd, sync_file->file);
 	sde_fence->fd = fd;
 
-	spin_lock(&ctx->list_lock);
-	list_add_tail(&sde_fence->fence_list, &ctx->fence_list_head);
-	spin_unlock(&ctx->list_lock);
+	_sde_fence_list_insert(ctx, sde_fence);
 
 exit:
 	return fd;
@@ -294,30 +316,61 @@ static void _sde_fence_trigger(struct sde_fence_context *ctx,
 {
 	unsigned long flags;
 	struct sde_fence *fc, *next;
-	bool is_signaled = false;
+	struct list_head expired;
+	unsigned int done_count;
+	u32 count = 0;
+	u64 latency;
 
 	kref_get(&ctx->kref);
+	INIT_LIST_HEAD(&expired);
 
+	/*
+	 * The list is ordered by seqno, so the expired fences form its head.
+	 * Cut them off in one go and stop at the first pending fence.
+	 */
 	spin_lock(&ctx->list_lock);
-	if (list_empty(&ctx->fence_list_head)) {
+	spin_lock_irqsave(&ctx->lock, flags);
+	done_count = ctx->done_count;
+	spin_unlock_irqrestore(&ctx->lock, flags);
+
+	list_for_each_entry(fc, &ctx->fence_list_head, fence_list) {
+		if ((int)(fc->base.seqno - done_count) > 0)
+			break;
+		count++;
+	}
+	if (count)
+		list_cut_position(&expired, &ctx->fence_list_head,
+				fc->fence_list.prev);
+	spin_unlock(&ctx->list_lock);
+
+	if (!count) {
 		SDE_DEBUG("nothing to trigger!\n");
 		goto end;
 	}
 
-	list_for_each_entry_safe(fc, next, &ctx->fence_list_head, fence_list) {
-		spin_lock_irqsave(&ctx->lock, flags);
+	/* signal the whole batch with one acquisition of the fence lock */
+	spin_lock_irqsave(&ctx->lock, flags);
+	list_for_each_entry(fc, &expired, fence_list) {
 		fc->base.error = error ? -EBUSY : 0;
 		fc->base.timestamp = ts;
-		is_signaled = dma_fence_is_signaled_locked(&fc->base);
-		spin_unlock_irqrestore(&ctx->lock, flags);
+		dma_fence_signal_locked(&fc->base);
+	}
 
-		if (is_signaled) {
-			list_del_init(&fc->fence_list);
-			dma_fence_put(&fc->base);
-		}
+	latency = ktime_to_ns(ktime_sub(ktime_get(), ts));
+	ctx->signal_count += count;
+	ctx->signal_batch_max = max(ctx->signal_batch_max, count);
+	ctx->signal_lat_total_ns += latency * count;
+	ctx->signal_lat_max_ns = max(ctx->signal_lat_max_ns, latency);
+	spin_unlock_irqrestore(&ctx->lock, flags);
+
+	SDE_EVT32(ctx->drm_id, done_count, count, latency);
+
+	/* drop the list references without holding any lock */
+	list_for_each_entry_safe(fc, next, &expired, fence_list) {
+		list_del_init(&fc->fence_list);
+		dma_fence_put(&fc->base);
 	}
 end:
-	spin_unlock(&ctx->list_lock);
 	kref_put(&ctx->kref, sde_fence_destroy);
 }
 
@@ -471,6 +524,11 @@ void sde_debugfs_timeline_dump(struct sde_fence_context *ctx,
 	seq_printf(*s, "drm obj:%s id:%d type:0x%x done_count:%d commit_count:%d\n",
 		obj_name, drm_obj->id, drm_obj->type, ctx->done_count,
 		ctx->commit_count);
+	seq_printf(*s, "signaled:%llu batch_max:%u latency avg:%lluns max:%lluns\n",
+		ctx->signal_count, ctx->signal_batch_max,
+		ctx->signal_count ? div64_u64(ctx->signal_lat_total_ns,
+			ctx->signal_count) : 0,
+		ctx->signal_lat_max_ns);
 
 	spin_lock(&ctx->list_lock);
 	list_for_each_entry_safe(fc, next, &ctx->fence_list_head, fence_list) {
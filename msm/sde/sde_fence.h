@@ -25,8 +25,13 @@
  * @lock: spinlock for fence counter protection
  * @list_lock: spinlock for timeline protection
  * @context: fence context
- * @list_head: fence list to hold all the fence created on this context
+ * @list_head: fence list to hold all the fence created on this context,
+ *	ordered by seqno
  * @name: name of fence context/timeline
+ * @signal_count: Number of fences signaled on this context
+ * @signal_batch_max: Largest number of fences signaled in one trigger
+ * @signal_lat_total_ns: Sum of hw done to fence signal latencies
+ * @signal_lat_max_ns: Largest hw done to fence signal latency
  */
 struct sde_fence_context {
 	unsigned int commit_count;
@@ -38,6 +43,10 @@ struct sde_fence_context {
 	u64 context;
 	struct list_head fence_list_head;
 	char name[SDE_FENCE_NAME_SIZE];
+	u64 signal_count;
+	u32 signal_batch_max;
+	u64 signal_lat_total_ns;
+	u64 signal_lat_max_ns;
 };
 
 /**
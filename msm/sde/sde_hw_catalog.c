@@ -4,6 +4,7 @@
  */
 
 #define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
+#include <linux/async.h>
 #include <linux/slab.h>
 #include <linux/of_address.h>
 #include <linux/platform_device.h>
@@ -4502,6 +4503,7 @@ void sde_hw_catalog_deinit(struct sde_mdss_cfg *sde_cfg)
 	kfree(sde_cfg->wb_formats);
 	kfree(sde_cfg->virt_vig_formats);
 	kfree(sde_cfg->inline_rot_formats);
+	kfree(sde_cfg->cache_strings);
 
 	kfree(sde_cfg);
 }
@@ -4509,11 +4511,104 @@ void sde_hw_catalog_deinit(struct sde_mdss_cfg *sde_cfg)
 /*************************************************************
  * hardware catalog init
  *************************************************************/
+typedef int (*sde_hw_catalog_parse_fn)(struct device_node *np,
+		struct sde_mdss_cfg *sde_cfg);
+
+#define SDE_HW_CATALOG_CHAIN_LEN	5
+
+/*
+ * Block parsers that only depend on the top, perf, qos, rot and uidle
+ * results. Each chain runs in order and chains run concurrently, so
+ * parsers writing the same catalog fields must share a chain.
+ */
+static const sde_hw_catalog_parse_fn
+sde_hw_catalog_chains[][SDE_HW_CATALOG_CHAIN_LEN] = {
+	{ sde_ctl_parse_dt },
+	/*
+	 * sspp, wb and reg_dma all fill mdp[].clk_ctrls; cdm parsing should
+	 * be done after intf and wb for mapping setup
+	 */
+	{ sde_sspp_parse_dt, sde_intf_parse_dt, sde_wb_parse_dt,
+		sde_cdm_parse_dt, sde_parse_reg_dma_dt },
+	/* mixer parsing should be done after dspp, ds and pp for mapping */
+	{ sde_dspp_top_parse_dt, sde_dspp_parse_dt, sde_ds_parse_dt,
+		sde_pp_parse_dt, sde_mixer_parse_dt },
+	{ sde_dsc_parse_dt },
+	{ sde_vbif_parse_dt },
+	{ sde_parse_merge_3d_dt },
+	{ sde_qdss_parse_dt },
+};
+
+/**
+ * struct sde_hw_catalog_chain_job - one concurrently parsed chain
+ * @chain: parsers to run in order
+ * @np: mdss device node
+ * @sde_cfg: catalog being populated
+ * @rc: result of the first failing parser, 0 on success
+ */
+struct sde_hw_catalog_chain_job {
+	const sde_hw_catalog_parse_fn *chain;
+	struct device_node *np;
+	struct sde_mdss_cfg *sde_cfg;
+	int rc;
+};
+
+static void _sde_hw_catalog_chain_work(void *data, async_cookie_t cookie)
+{
+	struct sde_hw_catalog_chain_job *job = data;
+	int i;
+
+	for (i = 0; i < SDE_HW_CATALOG_CHAIN_LEN && job->chain[i]; i++) {
+		job->rc = job->chain[i](job->np, job->sde_cfg);
+		if (job->rc)
+			break;
+	}
+}
+
+static int _sde_hw_catalog_parse_blocks(struct device_node *np,
+		struct sde_mdss_cfg *sde_cfg)
+{
+	struct sde_hw_catalog_chain_job jobs[ARRAY_SIZE(sde_hw_catalog_chains)];
+	ASYNC_DOMAIN_EXCLUSIVE(domain);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(jobs); i++) {
+		jobs[i].chain = sde_hw_catalog_chains[i];
+		jobs[i].np = np;
+		jobs[i].sde_cfg = sde_cfg;
+		jobs[i].rc = 0;
+
+		/* run the first chain inline, the others on the async pool */
+		if (i)
+			async_schedule_domain(_sde_hw_catalog_chain_work,
+					&jobs[i], &domain);
+	}
+
+	_sde_hw_catalog_chain_work(&jobs[0], 0);
+	async_synchronize_full_domain(&domain);
+
+	for (i = 0; i < ARRAY_SIZE(jobs); i++) {
+		if (jobs[i].rc) {
+			SDE_ERROR("parser chain %d failed %d\n", i, jobs[i].rc);
+			return jobs[i].rc;
+		}
+	}
+
+	return 0;
+}
+
 struct sde_mdss_cfg *sde_hw_catalog_init(struct drm_device *dev, u32 hw_rev)
 {
 	int rc;
 	struct sde_mdss_cfg *sde_cfg;
 	struct device_node *np = dev->dev->of_node;
+	ktime_t start;
+
+	sde_cfg = sde_hw_catalog_cache_load(dev->dev, hw_rev);
+	if (sde_cfg)
+		return sde_cfg;
+
+	start = ktime_get();
 
 	sde_cfg = kzalloc(sizeof(*sde_cfg), GFP_KERNEL);
 	if (!sde_cfg)
@@ -4549,67 +4644,7 @@ struct sde_mdss_cfg *sde_hw_catalog_init(struct drm_device *dev, u32 hw_rev)
 	if (rc)
 		goto end;
 
-	rc = sde_ctl_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_sspp_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_dspp_top_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_dspp_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_ds_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_dsc_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_pp_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	/* mixer parsing should be done after dspp,
-	 * ds and pp for mapping setup
-	 */
-	rc = sde_mixer_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_intf_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_wb_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	/* cdm parsing should be done after intf and wb for mapping setup */
-	rc = sde_cdm_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_vbif_parse_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_parse_reg_dma_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_parse_merge_3d_dt(np, sde_cfg);
-	if (rc)
-		goto end;
-
-	rc = sde_qdss_parse_dt(np, sde_cfg);
+	rc = _sde_hw_catalog_parse_blocks(np, sde_cfg);
 	if (rc)
 		goto end;
 
@@ -4617,6 +4652,9 @@ struct sde_mdss_cfg *sde_hw_catalog_init(struct drm_device *dev, u32 hw_rev)
 	if (rc)
 		goto end;
 
+	sde_hw_catalog_cache_store(dev->dev, sde_cfg,
+			ktime_to_ns(ktime_sub(ktime_get(), start)));
+
 	return sde_cfg;
 
 end:
@@ -1284,6 +1284,7 @@ struct sde_limit_cfg {
  * @has_cursor    indicates if hardware cursor is supported
  * @has_vig_p010  indicates if vig pipe supports p010 format
  * @inline_rot_formats	formats supported by the inline rotator feature
+ * @cache_strings  string table owned by a catalog loaded from the cache
  * @mdss_irqs	  bitmap with the irqs supported by the target
  */
 struct sde_mdss_cfg {
@@ -1411,6 +1412,7 @@ struct sde_mdss_cfg {
 	struct sde_format_extended *wb_formats;
 	struct sde_format_extended *virt_vig_formats;
 	struct sde_format_extended *inline_rot_formats;
+	char *cache_strings;
 
 	DECLARE_BITMAP(mdss_irqs, MDSS_INTR_MAX);
 };
@@ -1466,6 +1468,40 @@ struct sde_mdss_cfg *sde_hw_catalog_init(struct drm_device *dev, u32 hw_rev);
  */
 void sde_hw_catalog_deinit(struct sde_mdss_cfg *sde_cfg);
 
+/**
+ * sde_hw_catalog_cache_load - restore a catalog from the serialized cache
+ * @dev:          mdss device whose DT node the catalog was parsed from
+ * @hw_rev:       hardware revision of the catalog
+ *
+ * Only the blob stored by an earlier probe of the running kernel is used.
+ * It is accepted if its version, layout size, hw_rev, device tree hash
+ * and checksum all match.
+ * Return: restored catalog to be freed with sde_hw_catalog_deinit,
+ *         NULL on cache miss
+ */
+struct sde_mdss_cfg *sde_hw_catalog_cache_load(struct device *dev,
+		u32 hw_rev);
+
+/**
+ * sde_hw_catalog_cache_store - serialize a parsed catalog into the cache
+ * @dev:          mdss device whose DT node the catalog was parsed from
+ * @sde_cfg:      fully populated catalog
+ * @parse_ns:     time spent parsing the catalog, for statistics
+ */
+void sde_hw_catalog_cache_store(struct device *dev,
+		const struct sde_mdss_cfg *sde_cfg, u64 parse_ns);
+
+/**
+ * sde_hw_catalog_cache_debugfs_init - expose the cache statistics
+ * @debugfs_root: sde debugfs root directory
+ */
+void sde_hw_catalog_cache_debugfs_init(struct dentry *debugfs_root);
+
+/**
+ * sde_hw_catalog_cache_free - drop the blob kept for later probes
+ */
+void sde_hw_catalog_cache_free(void);
+
 /**
  * sde_hw_sspp_multirect_enabled - check multirect enabled for the sspp
  * @cfg:          pointer to sspp cfg
@@ -0,0 +1,667 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ */
+
+#define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
+
+#include <linux/crc32.h>
+#include <linux/debugfs.h>
+#include <linux/mutex.h>
+#include <linux/of.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+
+#include "sde_hw_catalog.h"
+#include "sde_kms.h"
+
+#define SDE_HW_CATALOG_CACHE_MAGIC	0x43454453	/* "SDEC" */
+/* bump whenever a catalog structure or the walk below changes */
+#define SDE_HW_CATALOG_CACHE_VERSION	2
+#define SDE_HW_CATALOG_CACHE_SHARED_MAX	16
+#define SDE_HW_CATALOG_CACHE_REC_HDR	8
+/* record length is checked by the caller, e.g. terminated lists */
+#define SDE_HW_CATALOG_CACHE_VAR_LEN	((size_t)-1)
+
+/**
+ * struct sde_hw_catalog_cache_hdr - header of a serialized catalog
+ * @magic: SDE_HW_CATALOG_CACHE_MAGIC
+ * @version: SDE_HW_CATALOG_CACHE_VERSION of the writer
+ * @cfg_size: sizeof(struct sde_mdss_cfg) of the writer
+ * @layout_hash: crc32 of the sizes of every serialized structure
+ * @hw_rev: hardware revision the catalog was parsed for
+ * @dt_hash: crc32 of the mdss device tree subtree
+ * @data_size: size of the catalog image and its records
+ * @str_size: size of the string table following the records
+ * @crc: crc32 of the data and the string table
+ *
+ * The payload starts with the struct sde_mdss_cfg image. Every pointer
+ * in it is replaced by the payload offset of a record holding a u32
+ * length and the pointed-to data, or of a string in the string table.
+ */
+struct sde_hw_catalog_cache_hdr {
+	u32 magic;
+	u32 version;
+	u32 cfg_size;
+	u32 layout_hash;
+	u32 hw_rev;
+	u32 dt_hash;
+	u32 data_size;
+	u32 str_size;
+	u32 crc;
+};
+
+enum sde_hw_catalog_cache_mode {
+	SDE_HW_CATALOG_CACHE_MEASURE,
+	SDE_HW_CATALOG_CACHE_STORE,
+	SDE_HW_CATALOG_CACHE_LOAD,
+};
+
+/**
+ * struct sde_hw_catalog_cache_ctx - state of one catalog walk
+ * @mode: measure the blob size, serialize into it or restore from it
+ * @data: payload of the blob, NULL while measuring
+ * @data_pos: end of the records written so far
+ * @data_size: size of the record area
+ * @str_pos: end of the strings written so far
+ * @str_size: size of the string table
+ * @strings: string table owned by the restored catalog
+ * @last_len: data length of the last visited record
+ * @err: first error of the walk
+ * @shared_cnt: number of valid @shared entries
+ * @shared: pointers referenced from more than one field, mapped from
+ *	the source value to the serialized or restored value
+ */
+struct sde_hw_catalog_cache_ctx {
+	enum sde_hw_catalog_cache_mode mode;
+	u8 *data;
+	u32 data_pos;
+	u32 data_size;
+	u32 str_pos;
+	u32 str_size;
+	char *strings;
+	u32 last_len;
+	int err;
+	u32 shared_cnt;
+	struct {
+		uintptr_t key;
+		uintptr_t val;
+	} shared[SDE_HW_CATALOG_CACHE_SHARED_MAX];
+};
+
+/**
+ * struct sde_hw_catalog_cache - blob kept across probes
+ * @lock: protects all members
+ * @blob: header and payload of the last stored catalog
+ * @size: size of @blob
+ * @hits: catalogs restored from the cache
+ * @misses: catalogs parsed from the device tree
+ * @load_us: duration of the last restore
+ * @parse_us: duration of the last device tree parse
+ *
+ * The blob lives in memory only and is never seeded from storage: its
+ * layout is only valid for the kernel build that wrote it.
+ */
+static struct sde_hw_catalog_cache {
+	struct mutex lock;
+	void *blob;
+	size_t size;
+	u32 hits;
+	u32 misses;
+	u32 load_us;
+	u32 parse_us;
+} sde_hw_catalog_cache = {
+	.lock = __MUTEX_INITIALIZER(sde_hw_catalog_cache.lock),
+};
+
+static bool _sde_hw_catalog_cache_shared(struct sde_hw_catalog_cache_ctx *c,
+		uintptr_t key, uintptr_t *val)
+{
+	u32 i;
+
+	for (i = 0; i < c->shared_cnt; i++) {
+		if (c->shared[i].key == key) {
+			*val = c->shared[i].val;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void _sde_hw_catalog_cache_share(struct sde_hw_catalog_cache_ctx *c,
+		uintptr_t key, uintptr_t val)
+{
+	if (c->shared_cnt >= SDE_HW_CATALOG_CACHE_SHARED_MAX) {
+		c->err = -E2BIG;
+		return;
+	}
+
+	c->shared[c->shared_cnt].key = key;
+	c->shared[c->shared_cnt].val = val;
+	c->shared_cnt++;
+}
+
+/*
+ * Visit one pointer field. @field is the address of the pointer, @len the
+ * size of the data it points to. On restore the record length has to match
+ * @len unless it is SDE_HW_CATALOG_CACHE_VAR_LEN. Returns the copy whose
+ * nested pointers are to be visited next, or NULL if there is nothing to
+ * descend into.
+ */
+static void *_sde_hw_catalog_cache_ptr(struct sde_hw_catalog_cache_ctx *c,
+		void *field, size_t len, bool shared)
+{
+	void **ptr = field;
+	uintptr_t key = (uintptr_t)*ptr, val;
+	void *copy = NULL;
+	u32 off;
+
+	c->last_len = 0;
+	if (!key)
+		return NULL;
+
+	/* after a failed restore step, leave nothing deinit could trip on */
+	if (c->mode == SDE_HW_CATALOG_CACHE_LOAD && c->err) {
+		*ptr = NULL;
+		return NULL;
+	}
+
+	if (shared && _sde_hw_catalog_cache_shared(c, key, &val)) {
+		if (c->mode != SDE_HW_CATALOG_CACHE_MEASURE)
+			*ptr = (void *)val;
+		return NULL;
+	}
+
+	switch (c->mode) {
+	case SDE_HW_CATALOG_CACHE_MEASURE:
+	case SDE_HW_CATALOG_CACHE_STORE:
+		off = ALIGN(c->data_pos, sizeof(u64));
+		c->data_pos = off + SDE_HW_CATALOG_CACHE_REC_HDR + len;
+		c->last_len = len;
+		if (c->mode == SDE_HW_CATALOG_CACHE_MEASURE) {
+			copy = *ptr;
+			val = key;
+			break;
+		}
+
+		*(u32 *)(c->data + off) = (u32)len;
+		copy = c->data + off + SDE_HW_CATALOG_CACHE_REC_HDR;
+		memcpy(copy, *ptr, len);
+		*ptr = (void *)(uintptr_t)off;
+		val = off;
+		break;
+	case SDE_HW_CATALOG_CACHE_LOAD:
+		*ptr = NULL;
+		if (key < sizeof(struct sde_mdss_cfg) ||
+				key > c->data_size - SDE_HW_CATALOG_CACHE_REC_HDR ||
+				!IS_ALIGNED(key, sizeof(u64))) {
+			c->err = -EINVAL;
+			return NULL;
+		}
+
+		off = *(u32 *)(c->data + key);
+		if (off > c->data_size - key - SDE_HW_CATALOG_CACHE_REC_HDR ||
+				(len != SDE_HW_CATALOG_CACHE_VAR_LEN &&
+				off != len)) {
+			c->err = -EINVAL;
+			return NULL;
+		}
+		len = off;
+
+		copy = kmemdup(c->data + key + SDE_HW_CATALOG_CACHE_REC_HDR,
+				len, GFP_KERNEL);
+		if (!copy) {
+			c->err = -ENOMEM;
+			return NULL;
+		}
+
+		*ptr = copy;
+		c->last_len = len;
+		val = (uintptr_t)copy;
+		break;
+	}
+
+	if (shared)
+		_sde_hw_catalog_cache_share(c, key, val);
+
+	return copy;
+}
+
+/* visit a field that must alias a pointer already visited as shared */
+static void _sde_hw_catalog_cache_ref(struct sde_hw_catalog_cache_ctx *c,
+		const void *field)
+{
+	void **ptr = (void **)field;
+	uintptr_t val;
+
+	if (!*ptr)
+		return;
+
+	if (c->mode == SDE_HW_CATALOG_CACHE_LOAD && c->err) {
+		*ptr = NULL;
+		return;
+	}
+
+	if (!_sde_hw_catalog_cache_shared(c, (uintptr_t)*ptr, &val)) {
+		c->err = -EINVAL;
+		if (c->mode == SDE_HW_CATALOG_CACHE_LOAD)
+			*ptr = NULL;
+		return;
+	}
+
+	if (c->mode != SDE_HW_CATALOG_CACHE_MEASURE)
+		*ptr = (void *)val;
+}
+
+static void _sde_hw_catalog_cache_str(struct sde_hw_catalog_cache_ctx *c,
+		const char **field)
+{
+	uintptr_t key = (uintptr_t)*field;
+	size_t len;
+
+	if (!key)
+		return;
+
+	switch (c->mode) {
+	case SDE_HW_CATALOG_CACHE_MEASURE:
+		c->str_pos += strlen(*field) + 1;
+		break;
+	case SDE_HW_CATALOG_CACHE_STORE:
+		len = strlen(*field) + 1;
+		memcpy(c->data + c->data_size + c->str_pos, *field, len);
+		*field = (const char *)(uintptr_t)(c->data_size + c->str_pos);
+		c->str_pos += len;
+		break;
+	case SDE_HW_CATALOG_CACHE_LOAD:
+		if (!c->err && (key < c->data_size ||
+				key >= c->data_size + c->str_size))
+			c->err = -EINVAL;
+
+		if (c->err) {
+			*field = NULL;
+			break;
+		}
+		*field = c->strings + (key - c->data_size);
+		break;
+	}
+}
+
+static size_t _sde_hw_catalog_cache_fmt_len(struct sde_hw_catalog_cache_ctx *c,
+		const struct sde_format_extended *list)
+{
+	size_t n = 0;
+
+	if (c->mode == SDE_HW_CATALOG_CACHE_LOAD)
+		return SDE_HW_CATALOG_CACHE_VAR_LEN;
+
+	if (!list)
+		return 0;
+
+	/* the lists are terminated by a zero fourcc, keep the terminator */
+	while (list[n].fourcc_format)
+		n++;
+
+	return (n + 1) * sizeof(*list);
+}
+
+static void _sde_hw_catalog_cache_fmt(struct sde_hw_catalog_cache_ctx *c,
+		struct sde_format_extended **field)
+{
+	struct sde_format_extended *list;
+	size_t n;
+
+	list = _sde_hw_catalog_cache_ptr(c, field,
+			_sde_hw_catalog_cache_fmt_len(c, *field), true);
+	if (!list || c->mode != SDE_HW_CATALOG_CACHE_LOAD)
+		return;
+
+	/* restored lists must be whole entries ending with the terminator */
+	n = c->last_len / sizeof(*list);
+	if (!n || c->last_len % sizeof(*list) || list[n - 1].fourcc_format)
+		c->err = -EINVAL;
+}
+
+static bool _sde_hw_catalog_cache_counts_valid(const struct sde_mdss_cfg *cfg)
+{
+	return cfg->sspp_count <= MAX_BLOCKS &&
+		cfg->mixer_count <= MAX_BLOCKS &&
+		cfg->dspp_count <= MAX_BLOCKS &&
+		cfg->ds_count <= MAX_BLOCKS &&
+		cfg->pingpong_count <= MAX_BLOCKS &&
+		cfg->wb_count <= MAX_BLOCKS &&
+		cfg->vbif_count <= MAX_BLOCKS &&
+		cfg->limit_count <= LIMIT_SUBBLK_COUNT_MAX;
+}
+
+/*
+ * Visit every pointer of the catalog. This has to cover everything that
+ * sde_hw_catalog_deinit frees plus all pointers aliasing those buffers.
+ */
+static void _sde_hw_catalog_cache_walk(struct sde_hw_catalog_cache_ctx *c,
+		struct sde_mdss_cfg *cfg)
+{
+	struct sde_sspp_sub_blks *sspp_sblk;
+	struct limit_vector_cfg *vec;
+	size_t qos_lut_len;
+	int i, j;
+
+	/* format lists first, the sub-blocks reference them */
+	_sde_hw_catalog_cache_fmt(c, &cfg->dma_formats);
+	_sde_hw_catalog_cache_fmt(c, &cfg->cursor_formats);
+	_sde_hw_catalog_cache_fmt(c, &cfg->vig_formats);
+	_sde_hw_catalog_cache_fmt(c, &cfg->wb_formats);
+	_sde_hw_catalog_cache_fmt(c, &cfg->virt_vig_formats);
+	_sde_hw_catalog_cache_fmt(c, &cfg->inline_rot_formats);
+
+	for (i = 0; i < cfg->sspp_count; i++) {
+		sspp_sblk = _sde_hw_catalog_cache_ptr(c, &cfg->sspp[i].sblk,
+				sizeof(*sspp_sblk), false);
+		if (!sspp_sblk)
+			continue;
+
+		_sde_hw_catalog_cache_ref(c, &sspp_sblk->format_list);
+		_sde_hw_catalog_cache_ref(c, &sspp_sblk->virt_format_list);
+		_sde_hw_catalog_cache_ref(c, &sspp_sblk->in_rot_format_list);
+	}
+
+	for (i = 0; i < cfg->mixer_count; i++)
+		_sde_hw_catalog_cache_ptr(c, &cfg->mixer[i].sblk,
+				sizeof(*cfg->mixer[i].sblk), false);
+
+	for (i = 0; i < cfg->dspp_count; i++)
+		_sde_hw_catalog_cache_ptr(c, &cfg->dspp[i].sblk,
+				sizeof(*cfg->dspp[i].sblk), false);
+
+	/* all ds blocks share the top configuration */
+	for (i = 0; i < cfg->ds_count; i++)
+		_sde_hw_catalog_cache_ptr(c, &cfg->ds[i].top,
+				sizeof(*cfg->ds[i].top), true);
+
+	for (i = 0; i < cfg->pingpong_count; i++)
+		_sde_hw_catalog_cache_ptr(c, &cfg->pingpong[i].sblk,
+				sizeof(*cfg->pingpong[i].sblk), false);
+
+	for (i = 0; i < cfg->wb_count; i++) {
+		_sde_hw_catalog_cache_ptr(c, &cfg->wb[i].sblk,
+				sizeof(*cfg->wb[i].sblk), false);
+		_sde_hw_catalog_cache_ref(c, &cfg->wb[i].format_list);
+	}
+
+	for (i = 0; i < cfg->vbif_count; i++) {
+		struct sde_vbif_cfg *vbif = &cfg->vbif[i];
+
+		_sde_hw_catalog_cache_ptr(c, &vbif->dynamic_ot_rd_tbl.cfg,
+				vbif->dynamic_ot_rd_tbl.count *
+				sizeof(*vbif->dynamic_ot_rd_tbl.cfg), false);
+		_sde_hw_catalog_cache_ptr(c, &vbif->dynamic_ot_wr_tbl.cfg,
+				vbif->dynamic_ot_wr_tbl.count *
+				sizeof(*vbif->dynamic_ot_wr_tbl.cfg), false);
+
+		for (j = VBIF_RT_CLIENT; j < VBIF_MAX_CLIENT; j++)
+			_sde_hw_catalog_cache_ptr(c,
+					&vbif->qos_tbl[j].priority_lvl,
+					vbif->qos_tbl[j].npriority_lvl *
+					sizeof(u32), false);
+	}
+
+	for (i = 0; i < cfg->limit_count; i++) {
+		struct sde_limit_cfg *limit = &cfg->limit_cfg[i];
+
+		_sde_hw_catalog_cache_str(c, &limit->name);
+
+		vec = _sde_hw_catalog_cache_ptr(c, &limit->vector_cfg,
+				limit->lmt_case_cnt * sizeof(*vec), false);
+		for (j = 0; vec && j < limit->lmt_case_cnt &&
+				(j + 1) * sizeof(*vec) <= c->last_len; j++)
+			_sde_hw_catalog_cache_str(c, &vec[j].usecase);
+
+		_sde_hw_catalog_cache_ptr(c, &limit->value_cfg,
+				limit->lmt_vec_cnt * sizeof(*limit->value_cfg),
+				false);
+	}
+
+	_sde_hw_catalog_cache_str(c, &cfg->perf.core_ib_ff);
+	_sde_hw_catalog_cache_str(c, &cfg->perf.core_clk_ff);
+	_sde_hw_catalog_cache_str(c, &cfg->perf.comp_ratio_rt);
+	_sde_hw_catalog_cache_str(c, &cfg->perf.comp_ratio_nrt);
+
+	qos_lut_len = cfg->perf.qos_refresh_count * SDE_QOS_LUT_USAGE_MAX *
+			sizeof(u64);
+	_sde_hw_catalog_cache_ptr(c, &cfg->perf.danger_lut, qos_lut_len, false);
+	_sde_hw_catalog_cache_ptr(c, &cfg->perf.safe_lut, qos_lut_len, false);
+	_sde_hw_catalog_cache_ptr(c, &cfg->perf.creq_lut, qos_lut_len, false);
+	_sde_hw_catalog_cache_ptr(c, &cfg->perf.qos_refresh_rate,
+			cfg->perf.qos_refresh_count * sizeof(u32), false);
+}
+
+/* sizes of every structure the walk serializes, see the walk above */
+static u32 _sde_hw_catalog_cache_layout_hash(void)
+{
+	const struct sde_mdss_cfg *cfg = NULL;
+	const u32 sizes[] = {
+		sizeof(*cfg),
+		sizeof(*cfg->dma_formats),
+		sizeof(*cfg->sspp[0].sblk),
+		sizeof(*cfg->mixer[0].sblk),
+		sizeof(*cfg->dspp[0].sblk),
+		sizeof(*cfg->ds[0].top),
+		sizeof(*cfg->pingpong[0].sblk),
+		sizeof(*cfg->wb[0].sblk),
+		sizeof(*cfg->vbif[0].dynamic_ot_rd_tbl.cfg),
+		sizeof(*cfg->vbif[0].dynamic_ot_wr_tbl.cfg),
+		sizeof(*cfg->vbif[0].qos_tbl[0].priority_lvl),
+		sizeof(*cfg->limit_cfg[0].vector_cfg),
+		sizeof(*cfg->limit_cfg[0].value_cfg),
+		sizeof(*cfg->perf.danger_lut),
+		sizeof(*cfg->perf.qos_refresh_rate),
+	};
+
+	return crc32_le(~0, (const u8 *)sizes, sizeof(sizes));
+}
+
+static u32 _sde_hw_catalog_dt_hash(struct device_node *np, u32 crc)
+{
+	struct device_node *child;
+	struct property *pp;
+
+	crc = crc32_le(crc, np->name, strlen(np->name));
+
+	for_each_property_of_node(np, pp) {
+		crc = crc32_le(crc, pp->name, strlen(pp->name));
+		crc = crc32_le(crc, pp->value, pp->length);
+	}
+
+	for_each_child_of_node(np, child)
+		crc = _sde_hw_catalog_dt_hash(child, crc);
+
+	return crc;
+}
+
+static struct sde_mdss_cfg *_sde_hw_catalog_cache_restore(const void *blob,
+		size_t size, u32 hw_rev, u32 dt_hash)
+{
+	const struct sde_hw_catalog_cache_hdr *hdr = blob;
+	struct sde_hw_catalog_cache_ctx c = {
+		.mode = SDE_HW_CATALOG_CACHE_LOAD,
+	};
+	struct sde_mdss_cfg *cfg;
+	u8 *payload;
+
+	if (!blob || size < sizeof(*hdr) ||
+			hdr->magic != SDE_HW_CATALOG_CACHE_MAGIC ||
+			hdr->version != SDE_HW_CATALOG_CACHE_VERSION ||
+			hdr->cfg_size != sizeof(*cfg) ||
+			hdr->layout_hash != _sde_hw_catalog_cache_layout_hash() ||
+			hdr->hw_rev != hw_rev || hdr->dt_hash != dt_hash ||
+			hdr->data_size < sizeof(*cfg) || !hdr->str_size ||
+			size - sizeof(*hdr) != (size_t)hdr->data_size +
+			hdr->str_size)
+		return NULL;
+
+	payload = (u8 *)(hdr + 1);
+	if (crc32_le(~0, payload, hdr->data_size + hdr->str_size) !=
+			hdr->crc) {
+		SDE_ERROR("catalog cache checksum mismatch\n");
+		return NULL;
+	}
+
+	if (payload[hdr->data_size + hdr->str_size - 1] != '\0')
+		return NULL;
+
+	c.data = payload;
+	c.data_size = hdr->data_size;
+	c.str_size = hdr->str_size;
+
+	cfg = kmemdup(payload, sizeof(*cfg), GFP_KERNEL);
+	if (!cfg)
+		return NULL;
+
+	c.strings = kmemdup(payload + c.data_size, c.str_size, GFP_KERNEL);
+	cfg->cache_strings = c.strings;
+	if (!c.strings || !_sde_hw_catalog_cache_counts_valid(cfg)) {
+		/* nothing restored yet, only the image pointers are bogus */
+		kfree(c.strings);
+		kfree(cfg);
+		return NULL;
+	}
+
+	_sde_hw_catalog_cache_walk(&c, cfg);
+	if (c.err) {
+		SDE_ERROR("catalog cache restore failed %d\n", c.err);
+		sde_hw_catalog_deinit(cfg);
+		return NULL;
+	}
+
+	return cfg;
+}
+
+struct sde_mdss_cfg *sde_hw_catalog_cache_load(struct device *dev, u32 hw_rev)
+{
+	struct sde_hw_catalog_cache *cache = &sde_hw_catalog_cache;
+	struct sde_mdss_cfg *cfg;
+	ktime_t start = ktime_get();
+	u32 dt_hash;
+
+	if (!dev || !dev->of_node)
+		return NULL;
+
+	dt_hash = _sde_hw_catalog_dt_hash(dev->of_node, ~0);
+
+	mutex_lock(&cache->lock);
+	cfg = _sde_hw_catalog_cache_restore(cache->blob, cache->size,
+			hw_rev, dt_hash);
+	if (cfg) {
+		cache->hits++;
+		cache->load_us = ktime_us_delta(ktime_get(), start);
+		SDE_DEBUG("catalog hw_rev 0x%x restored in %u us\n",
+				hw_rev, cache->load_us);
+	}
+	mutex_unlock(&cache->lock);
+
+	return cfg;
+}
+
+void sde_hw_catalog_cache_store(struct device *dev,
+		const struct sde_mdss_cfg *sde_cfg, u64 parse_ns)
+{
+	struct sde_hw_catalog_cache *cache = &sde_hw_catalog_cache;
+	struct sde_hw_catalog_cache_ctx c = {
+		.mode = SDE_HW_CATALOG_CACHE_MEASURE,
+	};
+	struct sde_hw_catalog_cache_hdr *hdr;
+	struct sde_mdss_cfg *image;
+	size_t size;
+	void *blob;
+
+	if (!dev || !dev->of_node || !sde_cfg)
+		return;
+
+	mutex_lock(&cache->lock);
+	cache->misses++;
+	cache->parse_us = div_u64(parse_ns, NSEC_PER_USEC);
+	mutex_unlock(&cache->lock);
+
+	/* measuring only reads the catalog */
+	c.data_pos = sizeof(*sde_cfg);
+	_sde_hw_catalog_cache_walk(&c, (struct sde_mdss_cfg *)sde_cfg);
+	if (c.err || !c.str_pos)
+		return;
+
+	c.data_size = ALIGN(c.data_pos, sizeof(u64));
+	c.str_size = c.str_pos;
+	size = sizeof(*hdr) + c.data_size + c.str_size;
+
+	blob = vzalloc(size);
+	if (!blob)
+		return;
+
+	hdr = blob;
+	c.mode = SDE_HW_CATALOG_CACHE_STORE;
+	c.data = (u8 *)(hdr + 1);
+	c.data_pos = sizeof(*sde_cfg);
+	c.str_pos = 0;
+	c.shared_cnt = 0;
+
+	image = (struct sde_mdss_cfg *)c.data;
+	memcpy(image, sde_cfg, sizeof(*image));
+	image->cache_strings = NULL;
+	_sde_hw_catalog_cache_walk(&c, image);
+	if (c.err) {
+		SDE_ERROR("catalog cache serialization failed %d\n", c.err);
+		vfree(blob);
+		return;
+	}
+
+	hdr->magic = SDE_HW_CATALOG_CACHE_MAGIC;
+	hdr->version = SDE_HW_CATALOG_CACHE_VERSION;
+	hdr->cfg_size = sizeof(*image);
+	hdr->layout_hash = _sde_hw_catalog_cache_layout_hash();
+	hdr->hw_rev = sde_cfg->hwversion;
+	hdr->dt_hash = _sde_hw_catalog_dt_hash(dev->of_node, ~0);
+	hdr->data_size = c.data_size;
+	hdr->str_size = c.str_size;
+	hdr->crc = crc32_le(~0, c.data, c.data_size + c.str_size);
+
+	mutex_lock(&cache->lock);
+	vfree(cache->blob);
+	cache->blob = blob;
+	cache->size = size;
+	mutex_unlock(&cache->lock);
+
+	SDE_DEBUG("catalog hw_rev 0x%x parsed in %llu us, cached %zu bytes\n",
+			sde_cfg->hwversion, div_u64(parse_ns, NSEC_PER_USEC),
+			size);
+}
+
+void sde_hw_catalog_cache_free(void)
+{
+	struct sde_hw_catalog_cache *cache = &sde_hw_catalog_cache;
+
+	mutex_lock(&cache->lock);
+	vfree(cache->blob);
+	cache->blob = NULL;
+	cache->size = 0;
+	mutex_unlock(&cache->lock);
+}
+
+#ifdef CONFIG_DEBUG_FS
+void sde_hw_catalog_cache_debugfs_init(struct dentry *debugfs_root)
+{
+	struct sde_hw_catalog_cache *cache = &sde_hw_catalog_cache;
+	struct dentry *dir;
+
+	dir = debugfs_create_dir("hw_catalog", debugfs_root);
+	if (IS_ERR_OR_NULL(dir))
+		return;
+
+	debugfs_create_u32("hits", 0400, dir, &cache->hits);
+	debugfs_create_u32("misses", 0400, dir, &cache->misses);
+	debugfs_create_u32("load_us", 0400, dir, &cache->load_us);
+	debugfs_create_u32("parse_us", 0400, dir, &cache->parse_us);
+}
+#else
+void sde_hw_catalog_cache_debugfs_init(struct dentry *debugfs_root)
+{
+}
+#endif /* CONFIG_DEBUG_FS */
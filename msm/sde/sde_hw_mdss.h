@@ -533,6 +533,8 @@ struct sde_mdss_color {
  * @dspp[DSPP_MAX]: array of hw_dspp pointers associated with crtc.
  * @broadcast_disabled: flag indicating if broadcast should be avoided when
  *			using LUTDMA
+ * @payload_crc: crc of the payload computed when the property was set,
+ *			0 if the payload may not be cached
  */
 struct sde_hw_cp_cfg {
 	void *payload;
@@ -545,6 +547,7 @@ struct sde_hw_cp_cfg {
 	u32 displayh;
 	struct sde_hw_dspp *dspp[DSPP_MAX];
 	bool broadcast_disabled;
+	u32 payload_crc;
 };
 
 /**
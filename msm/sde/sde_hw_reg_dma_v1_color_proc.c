@@ -118,6 +118,34 @@ static struct sde_reg_dma_buffer
 	*sspp_buf[SDE_SSPP_RECT_MAX][REG_DMA_FEATURES_MAX][SSPP_MAX];
 static struct sde_reg_dma_buffer *ltm_buf[REG_DMA_FEATURES_MAX][LTM_MAX];
 
+/**
+ * struct reg_dma_payload_cache - double buffered prebuilt dspp payloads
+ * @buf: payload buffers, buf[0] aliases the feature dspp_buf
+ * @crc: payload crc each buffer was built from, 0 if the buffer is stale
+ * @blk: dspp block mask each buffer was built for
+ * @op_mode: feature op mode each buffer was built with
+ * @payload: copy of the property payload each buffer was built from
+ * @len: length of @payload in bytes
+ * @cur: index of the buffer last kicked off
+ */
+struct reg_dma_payload_cache {
+	struct sde_reg_dma_buffer *buf[2];
+	u32 crc[2];
+	u32 blk[2];
+	u32 op_mode[2];
+	void *payload[2];
+	u32 len[2];
+	u32 cur;
+};
+
+static struct reg_dma_payload_cache dspp_cache[REG_DMA_FEATURES_MAX][DSPP_MAX];
+
+/* dspp features whose payloads are cached across commits */
+static bool dspp_cache_en[REG_DMA_FEATURES_MAX] = {
+	[GAMUT] = true,
+	[PCC] = true,
+};
+
 static u32 feature_map[SDE_DSPP_MAX] = {
 	[SDE_DSPP_VLUT] = VLUT,
 	[SDE_DSPP_GAMUT] = GAMUT,
@@ -291,6 +319,122 @@ static int reg_dma_dspp_check(struct sde_hw_dspp *ctx, void *cfg,
 	return 0;
 }
 
+static int reg_dmav1_dspp_cache_init(enum sde_reg_dma_features feature,
+		enum sde_dspp idx, u32 size)
+{
+	struct reg_dma_payload_cache *cache = &dspp_cache[feature][idx];
+	int rc;
+
+	rc = reg_dma_buf_init(&cache->buf[1], size);
+	if (rc)
+		return rc;
+
+	cache->buf[0] = dspp_buf[feature][idx];
+	cache->crc[0] = 0;
+	cache->crc[1] = 0;
+	cache->cur = 0;
+	return 0;
+}
+
+/**
+ * reg_dmav1_dspp_cache_get - look up a prebuilt payload for a dspp feature
+ * @feature: reg dma feature
+ * @idx: dspp index
+ * @hw_cfg: color processing config, payload_crc is 0 if the payload
+ *	can't be cached
+ * @blk: dspp block mask the payload targets
+ * @op_mode: feature op mode the payload programs
+ * @hit: set to true if the returned buffer is ready to be kicked off
+ * Return: buffer to kick off on a hit, otherwise the buffer to build into;
+ *	the buffer in flight from the previous kick off is never returned
+ *	for rebuilding. A buffer to build into is invalidated, and becomes
+ *	current only once reg_dmav1_dspp_cache_set reports a completed build.
+ *
+ * The crc only narrows the search, a buffer is reused only if the payload
+ * it was built from is byte for byte identical to hw_cfg->payload.
+ */
+static struct sde_reg_dma_buffer *reg_dmav1_dspp_cache_get(
+		enum sde_reg_dma_features feature, enum sde_dspp idx,
+		struct sde_hw_cp_cfg *hw_cfg, u32 blk, u32 op_mode, bool *hit)
+{
+	struct reg_dma_payload_cache *cache = &dspp_cache[feature][idx];
+	u32 crc = hw_cfg->payload_crc;
+	u32 i;
+
+	*hit = false;
+	if (!cache->buf[1])
+		return dspp_buf[feature][idx];
+
+	for (i = 0; crc && i < ARRAY_SIZE(cache->buf); i++) {
+		if (cache->crc[i] == crc && cache->blk[i] == blk &&
+				cache->op_mode[i] == op_mode &&
+				cache->len[i] == hw_cfg->len &&
+				!memcmp(cache->payload[i], hw_cfg->payload,
+					hw_cfg->len)) {
+			cache->cur = i;
+			*hit = true;
+			return cache->buf[i];
+		}
+	}
+
+	i = cache->cur ^ 1;
+	cache->crc[i] = 0;
+	return cache->buf[i];
+}
+
+/**
+ * reg_dmav1_dspp_cache_set - make the buffer just built current and tag it
+ * @feature: reg dma feature
+ * @idx: dspp index
+ * @hw_cfg: color processing config the buffer was built from
+ * @blk: dspp block mask the payload targets
+ * @op_mode: feature op mode the payload programs
+ */
+static void reg_dmav1_dspp_cache_set(enum sde_reg_dma_features feature,
+		enum sde_dspp idx, struct sde_hw_cp_cfg *hw_cfg, u32 blk,
+		u32 op_mode)
+{
+	struct reg_dma_payload_cache *cache = &dspp_cache[feature][idx];
+	u32 cur;
+
+	if (!cache->buf[1])
+		return;
+
+	/* the build succeeded, it is the buffer kicked off from now on */
+	cache->cur ^= 1;
+	cur = cache->cur;
+	if (!hw_cfg->payload_crc || !hw_cfg->payload)
+		return;
+
+	if (cache->len[cur] != hw_cfg->len) {
+		kvfree(cache->payload[cur]);
+		cache->len[cur] = 0;
+		cache->payload[cur] = kvmalloc(hw_cfg->len, GFP_KERNEL);
+		if (!cache->payload[cur])
+			return;
+		cache->len[cur] = hw_cfg->len;
+	}
+
+	memcpy(cache->payload[cur], hw_cfg->payload, hw_cfg->len);
+	cache->crc[cur] = hw_cfg->payload_crc;
+	cache->blk[cur] = blk;
+	cache->op_mode[cur] = op_mode;
+}
+
+/**
+ * reg_dmav1_dspp_cache_reset - mark dspp_buf as rebuilt outside the cache
+ * @feature: reg dma feature
+ * @idx: dspp index
+ */
+static void reg_dmav1_dspp_cache_reset(enum sde_reg_dma_features feature,
+		enum sde_dspp idx)
+{
+	struct reg_dma_payload_cache *cache = &dspp_cache[feature][idx];
+
+	cache->crc[0] = 0;
+	cache->cur = 0;
+}
+
 int reg_dmav1_init_dspp_op_v4(int feature, enum sde_dspp idx)
 {
 	int rc = -ENOTSUPP;
@@ -343,6 +487,10 @@ int reg_dmav1_init_dspp_op_v4(int feature, enum sde_dspp idx)
 			rc = reg_dma_buf_init(
 				&dspp_buf[feature_map[feature]][idx],
 				feature_reg_dma_sz[feature]);
+			if (!rc && dspp_cache_en[feature_map[feature]])
+				rc = reg_dmav1_dspp_cache_init(
+					feature_map[feature], idx,
+					feature_reg_dma_sz[feature]);
 		}
 
 	}
@@ -624,6 +772,7 @@ static void dspp_3d_gamutv4_off(struct sde_hw_dspp *ctx, void *cfg)
 
 	dma_ops = sde_reg_dma_get_ops();
 	dma_ops->reset_reg_dma_buf(dspp_buf[GAMUT][ctx->idx]);
+	reg_dmav1_dspp_cache_reset(GAMUT, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, GAMUT, dspp_buf[GAMUT][ctx->idx]);
 
@@ -661,6 +810,8 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 	u32 *scale_data;
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct sde_hw_reg_dma_ops *dma_ops;
+	struct sde_reg_dma_buffer *buf;
+	bool hit;
 	int rc;
 	u32 num_of_mixers, blk = 0;
 
@@ -698,9 +849,14 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 	}
 
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[GAMUT][ctx->idx]);
+	buf = reg_dmav1_dspp_cache_get(GAMUT, ctx->idx, hw_cfg, blk, op_mode,
+			&hit);
+	if (hit)
+		goto queue_buf;
 
-	REG_DMA_INIT_OPS(dma_write_cfg, blk, GAMUT, dspp_buf[GAMUT][ctx->idx]);
+	dma_ops->reset_reg_dma_buf(buf);
+
+	REG_DMA_INIT_OPS(dma_write_cfg, blk, GAMUT, buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -760,8 +916,10 @@ static void reg_dmav1_setup_dspp_3d_gamutv4_common(struct sde_hw_dspp *ctx,
 		DRM_ERROR("opmode write single reg failed ret %d\n", rc);
 		return;
 	}
+	reg_dmav1_dspp_cache_set(GAMUT, ctx->idx, hw_cfg, blk, op_mode);
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[GAMUT][ctx->idx],
+queue_buf:
+	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, buf,
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
 	rc = dma_ops->kick_off(&kick_off);
 	if (rc)
@@ -1124,6 +1282,7 @@ static void _dspp_pccv4_off(struct sde_hw_dspp *ctx, void *cfg)
 
 	dma_ops = sde_reg_dma_get_ops();
 	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
+	reg_dmav1_dspp_cache_reset(PCC, ctx->idx);
 
 	REG_DMA_INIT_OPS(dma_write_cfg, blk, PCC, dspp_buf[PCC][ctx->idx]);
 
@@ -1159,7 +1318,9 @@ void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 	struct sde_reg_dma_setup_ops_cfg dma_write_cfg;
 	struct drm_msm_pcc *pcc_cfg;
 	struct drm_msm_pcc_coeff *coeffs = NULL;
+	struct sde_reg_dma_buffer *buf;
 	u32 *data = NULL;
+	bool hit;
 	int rc, i = 0;
 	u32 reg = 0;
 	u32 num_of_mixers, blk = 0;
@@ -1191,9 +1352,14 @@ void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 
 	pcc_cfg = hw_cfg->payload;
 	dma_ops = sde_reg_dma_get_ops();
-	dma_ops->reset_reg_dma_buf(dspp_buf[PCC][ctx->idx]);
+	buf = reg_dmav1_dspp_cache_get(PCC, ctx->idx, hw_cfg, blk, PCC_EN,
+			&hit);
+	if (hit)
+		goto queue_buf;
 
-	REG_DMA_INIT_OPS(dma_write_cfg, blk, PCC, dspp_buf[PCC][ctx->idx]);
+	dma_ops->reset_reg_dma_buf(buf);
+
+	REG_DMA_INIT_OPS(dma_write_cfg, blk, PCC, buf);
 
 	REG_DMA_SETUP_OPS(dma_write_cfg, 0, NULL, 0, HW_BLK_SELECT, 0, 0, 0);
 	rc = dma_ops->setup_payload(&dma_write_cfg);
@@ -1260,8 +1426,10 @@ void reg_dmav1_setup_dspp_pccv4(struct sde_hw_dspp *ctx, void *cfg)
 		DRM_ERROR("setting opcode failed ret %d\n", rc);
 		goto exit;
 	}
+	reg_dmav1_dspp_cache_set(PCC, ctx->idx, hw_cfg, blk, PCC_EN);
 
-	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, dspp_buf[PCC][ctx->idx],
+queue_buf:
+	REG_DMA_SETUP_KICKOFF(kick_off, hw_cfg->ctl, buf,
 			REG_DMA_WRITE, DMA_CTL_QUEUE0, WRITE_IMMEDIATE);
 	rc = dma_ops->kick_off(&kick_off);
 	if (rc)
@@ -1597,6 +1765,12 @@ int reg_dmav1_deinit_dspp_ops(enum sde_dspp idx)
 	}
 
 	for (i = 0; i < REG_DMA_FEATURES_MAX; i++) {
+		if (dspp_cache[i][idx].buf[1])
+			dma_ops->dealloc_reg_dma(dspp_cache[i][idx].buf[1]);
+		kvfree(dspp_cache[i][idx].payload[0]);
+		kvfree(dspp_cache[i][idx].payload[1]);
+		memset(&dspp_cache[i][idx], 0, sizeof(dspp_cache[i][idx]));
+
 		if (!dspp_buf[i][idx])
 			continue;
 		dma_ops->dealloc_reg_dma(dspp_buf[i][idx]);
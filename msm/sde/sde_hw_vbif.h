@@ -94,6 +94,62 @@ struct sde_hw_vbif_ops {
 	void (*set_write_gather_en)(struct sde_hw_vbif *vbif, u32 xin_id);
 };
 
+/**
+ * struct sde_hw_vbif_shadow - last settings programmed per xin client
+ *	Entries are only trusted while the matching bit of the valid mask
+ *	is set; all masks are cleared when the block loses power.
+ * @ot_rd: read OT limit per xin
+ * @ot_wr: write OT limit per xin
+ * @qos_client: client type whose QoS remap table was applied per xin
+ * @ot_rd_valid: mask of xins with a valid @ot_rd entry
+ * @ot_wr_valid: mask of xins with a valid @ot_wr entry
+ * @wr_gather_valid: mask of xins with write gather known enabled
+ * @qos_valid: mask of xins with a valid @qos_client entry
+ */
+struct sde_hw_vbif_shadow {
+	u32 ot_rd[MAX_XIN_COUNT];
+	u32 ot_wr[MAX_XIN_COUNT];
+	u32 qos_client[MAX_XIN_COUNT];
+	u32 ot_rd_valid;
+	u32 ot_wr_valid;
+	u32 wr_gather_valid;
+	u32 qos_valid;
+};
+
+/**
+ * struct sde_hw_vbif_pending - OT limits deferred to the next flush
+ * @ot_rd: read OT limit to program per xin
+ * @ot_wr: write OT limit to program per xin
+ * @clk_ctrl: clock control identifier per xin
+ * @rd_mask: mask of xins with a pending read limit
+ * @wr_mask: mask of xins with a pending write limit
+ */
+struct sde_hw_vbif_pending {
+	u32 ot_rd[MAX_XIN_COUNT];
+	u32 ot_wr[MAX_XIN_COUNT];
+	u32 clk_ctrl[MAX_XIN_COUNT];
+	u32 rd_mask;
+	u32 wr_mask;
+};
+
+/**
+ * struct sde_hw_vbif_stats - OT/QoS programming counters
+ * @ot_updates: OT limits written to hardware
+ * @halts: xin halt/unhalt cycles issued for OT updates
+ * @halts_avoided: OT requests dropped because the limit was unchanged
+ * @batches: flushes that applied more than one deferred OT limit
+ * @qos_updates: QoS remap tables written to hardware
+ * @qos_skipped: QoS remap requests dropped because nothing changed
+ */
+struct sde_hw_vbif_stats {
+	u64 ot_updates;
+	u64 halts;
+	u64 halts_avoided;
+	u64 batches;
+	u64 qos_updates;
+	u64 qos_skipped;
+};
+
 struct sde_hw_vbif {
 	/* base */
 	struct sde_hw_blk_reg_map hw;
@@ -110,6 +166,11 @@ struct sde_hw_vbif {
 	 * must be take by client before using any ops
 	 */
 	struct mutex mutex;
+
+	/* programming state, protected by mutex */
+	struct sde_hw_vbif_shadow shadow;
+	struct sde_hw_vbif_pending pending;
+	struct sde_hw_vbif_stats stats;
 };
 
 /**
@@ -133,6 +133,55 @@ void *sde_debugfs_get_root(struct sde_kms *sde_kms)
 	return priv->debug_root;
 }
 
+static const char * const sde_kms_pm_phase_names[SDE_KMS_PM_PHASE_MAX] = {
+	[SDE_KMS_PM_SUSPEND_SNAPSHOT] = "suspend_snapshot",
+	[SDE_KMS_PM_SUSPEND_DISABLE] = "suspend_disable",
+	[SDE_KMS_PM_SUSPEND_IDLE] = "suspend_idle",
+	[SDE_KMS_PM_RESUME_RESET] = "resume_reset",
+	[SDE_KMS_PM_RESUME_RESTORE] = "resume_restore",
+	[SDE_KMS_PM_RESUME_FAST] = "resume_fast",
+};
+
+static int _sde_debugfs_pm_latency_show(struct seq_file *s, void *v)
+{
+	struct sde_kms *sde_kms = s->private;
+	const struct sde_kms_pm_hist *hist;
+	int i, j;
+
+	for (i = 0; i < SDE_KMS_PM_PHASE_MAX; i++) {
+		hist = &sde_kms->pm_hist[i];
+		seq_printf(s, "%s: count:%u last:%lluus max:%lluus\n",
+				sde_kms_pm_phase_names[i], hist->count,
+				hist->last_us, hist->max_us);
+
+		for (j = 0; j < SDE_KMS_PM_HIST_BUCKETS; j++) {
+			if (!hist->buckets[j])
+				continue;
+			seq_printf(s, "  <%lluus: %u\n",
+					j < SDE_KMS_PM_HIST_BUCKETS - 1 ?
+					1ULL << j : U64_MAX,
+					hist->buckets[j]);
+		}
+	}
+
+	return 0;
+}
+
+static int _sde_debugfs_pm_latency_open(struct inode *inode,
+		struct file *file)
+{
+	return single_open(file, _sde_debugfs_pm_latency_show,
+			inode->i_private);
+}
+
+static const struct file_operations _sde_debugfs_pm_latency_fops = {
+	.owner = THIS_MODULE,
+	.open = _sde_debugfs_pm_latency_open,
+	.release = single_release,
+	.read = seq_read,
+	.llseek = seq_lseek,
+};
+
 static int _sde_debugfs_init(struct sde_kms *sde_kms)
 {
 	void *p;
@@ -153,6 +202,7 @@ static int _sde_debugfs_init(struct sde_kms *sde_kms)
 
 	(void) sde_debugfs_vbif_init(sde_kms, debugfs_root);
 	(void) sde_debugfs_core_irq_init(sde_kms, debugfs_root);
+	sde_hw_catalog_cache_debugfs_init(debugfs_root);
 
 	rc = sde_core_perf_debugfs_init(&sde_kms->perf, debugfs_root);
 	if (rc) {
@@ -164,6 +214,9 @@ static int _sde_debugfs_init(struct sde_kms *sde_kms)
 		debugfs_create_u32("qdss", 0600, debugfs_root,
 				(u32 *)&sde_kms->qdss_enabled);
 
+	debugfs_create_file("pm_latency", 0400, debugfs_root, sde_kms,
+			&_sde_debugfs_pm_latency_fops);
+
 	return 0;
 }
 
@@ -1045,6 +1098,12 @@ static void sde_kms_commit(struct msm_kms *kms,
 	}
 
 	SDE_ATRACE_BEGIN("sde_kms_commit");
+
+	sde_kms->commit_count++;
+
+	/* catch limits queued by a crtc that skipped its atomic flush */
+	sde_vbif_flush_pending(sde_kms);
+
 	for_each_old_crtc_in_state(old_state, crtc, old_crtc_state, i) {
 		if (crtc->state->active) {
 			SDE_EVT32(DRMID(crtc));
@@ -3006,6 +3065,38 @@ static void _sde_kms_pm_suspend_idle_helper(struct sde_kms *sde_kms,
 	kthread_flush_worker(&priv->pp_event_worker);
 }
 
+static void _sde_kms_pm_record(struct sde_kms *sde_kms,
+		enum sde_kms_pm_phase phase, ktime_t start)
+{
+	struct sde_kms_pm_hist *hist = &sde_kms->pm_hist[phase];
+	u64 us = ktime_us_delta(ktime_get(), start);
+
+	hist->buckets[min_t(int, fls64(us), SDE_KMS_PM_HIST_BUCKETS - 1)]++;
+	hist->count++;
+	hist->last_us = us;
+	hist->max_us = max(hist->max_us, us);
+
+	SDE_EVT32(phase, us);
+}
+
+/*
+ * _sde_kms_pm_snapshot_idle - whether the saved state has no enabled crtc,
+ *	in which case resume has nothing to restore
+ */
+static bool _sde_kms_pm_snapshot_idle(struct drm_atomic_state *state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *crtc_state;
+	int i;
+
+	for_each_new_crtc_in_state(state, crtc, crtc_state, i) {
+		if (crtc_state->enable)
+			return false;
+	}
+
+	return true;
+}
+
 static int sde_kms_pm_suspend(struct device *dev)
 {
 	struct drm_device *ddev;
@@ -3015,6 +3106,7 @@ static int sde_kms_pm_suspend(struct device *dev)
 	struct drm_connector_list_iter conn_iter;
 	struct drm_atomic_state *state = NULL;
 	struct sde_kms *sde_kms;
+	ktime_t start;
 	int ret = 0, num_crtcs = 0;
 
 	if (!dev)
@@ -3045,6 +3137,8 @@ retry:
 		goto unlock;
 
 	/* save current state for resume */
+	start = ktime_get();
+	sde_kms->pm_snapshot.valid = false;
 	if (sde_kms->suspend_state)
 		drm_atomic_state_put(sde_kms->suspend_state);
 	sde_kms->suspend_state = drm_atomic_helper_duplicate_state(ddev, &ctx);
@@ -3055,6 +3149,10 @@ retry:
 		goto unlock;
 	}
 
+	sde_kms->pm_snapshot.idle =
+		_sde_kms_pm_snapshot_idle(sde_kms->suspend_state);
+	_sde_kms_pm_record(sde_kms, SDE_KMS_PM_SUSPEND_SNAPSHOT, start);
+
 	/* create atomic state to disable all CRTCs */
 	state = drm_atomic_state_alloc(ddev);
 	if (!state) {
@@ -3108,20 +3206,27 @@ retry:
 	/* check for nothing to do */
 	if (num_crtcs == 0) {
 		DRM_DEBUG("all crtcs are already in the off state\n");
-		sde_kms->suspend_block = true;
-		_sde_kms_pm_suspend_idle_helper(sde_kms, dev);
-		goto unlock;
+		goto idle;
 	}
 
 	/* commit the "disable all" state */
+	start = ktime_get();
 	ret = drm_atomic_commit(state);
 	if (ret < 0) {
 		DRM_ERROR("failed to disable crtcs, %d\n", ret);
 		goto unlock;
 	}
+	_sde_kms_pm_record(sde_kms, SDE_KMS_PM_SUSPEND_DISABLE, start);
 
+idle:
+	start = ktime_get();
 	sde_kms->suspend_block = true;
 	_sde_kms_pm_suspend_idle_helper(sde_kms, dev);
+	_sde_kms_pm_record(sde_kms, SDE_KMS_PM_SUSPEND_IDLE, start);
+
+	/* anything committed after this point invalidates the snapshot */
+	sde_kms->pm_snapshot.commit_count = sde_kms->commit_count;
+	sde_kms->pm_snapshot.valid = true;
 
 unlock:
 	if (state) {
@@ -3154,6 +3259,8 @@ static int sde_kms_pm_resume(struct device *dev)
 	struct drm_device *ddev;
 	struct sde_kms *sde_kms;
 	struct drm_modeset_acquire_ctx ctx;
+	bool fast;
+	ktime_t start;
 	int ret, i;
 
 	if (!dev)
@@ -3165,9 +3272,24 @@ static int sde_kms_pm_resume(struct device *dev)
 
 	sde_kms = to_sde_kms(ddev_to_msm_kms(ddev));
 
-	SDE_EVT32(sde_kms->suspend_state != NULL);
+	/*
+	 * If no crtc was enabled at suspend and nothing was committed since,
+	 * the current state already matches the saved one. Skip the software
+	 * reset and the restore commit, which would only run the full
+	 * check/commit pipeline to program nothing.
+	 */
+	fast = sde_kms->suspend_state && sde_kms->pm_snapshot.valid &&
+		sde_kms->pm_snapshot.idle &&
+		sde_kms->pm_snapshot.commit_count == sde_kms->commit_count;
+	sde_kms->pm_snapshot.valid = false;
+
+	SDE_EVT32(sde_kms->suspend_state != NULL, fast);
 
-	drm_mode_config_reset(ddev);
+	start = ktime_get();
+	if (!fast) {
+		drm_mode_config_reset(ddev);
+		_sde_kms_pm_record(sde_kms, SDE_KMS_PM_RESUME_RESET, start);
+	}
 
 	drm_modeset_acquire_init(&ctx, 0);
 retry:
@@ -3181,7 +3303,12 @@ retry:
 
 	sde_kms->suspend_block = false;
 
-	if (sde_kms->suspend_state) {
+	if (fast) {
+		drm_atomic_state_put(sde_kms->suspend_state);
+		sde_kms->suspend_state = NULL;
+		_sde_kms_pm_record(sde_kms, SDE_KMS_PM_RESUME_FAST, start);
+	} else if (sde_kms->suspend_state) {
+		start = ktime_get();
 		sde_kms->suspend_state->acquire_ctx = &ctx;
 		for (i = 0; i < TEARDOWN_DEADLOCK_RETRY_MAX; i++) {
 			ret = drm_atomic_helper_commit_duplicated_state(
@@ -3194,6 +3321,9 @@ retry:
 
 		if (ret < 0)
 			DRM_ERROR("failed to restore state, %d\n", ret);
+		else
+			_sde_kms_pm_record(sde_kms, SDE_KMS_PM_RESUME_RESTORE,
+					start);
 
 		drm_atomic_state_put(sde_kms->suspend_state);
 		sde_kms->suspend_state = NULL;
@@ -3440,6 +3570,7 @@ static void sde_kms_handle_power_event(u32 event_type, void *usr)
 
 	if (event_type == SDE_POWER_EVENT_POST_ENABLE) {
 		sde_irq_update(msm_kms, true);
+		sde_vbif_invalidate_state(sde_kms);
 		sde_vbif_init_memtypes(sde_kms);
 		sde_kms_init_shared_hw(sde_kms);
 		_sde_kms_set_lutdma_vbif_remap(sde_kms);
@@ -232,6 +232,54 @@ struct sde_irq {
 	struct dentry *debugfs_file;
 };
 
+/**
+ * enum sde_kms_pm_phase - system suspend/resume phases with latency tracking
+ * @SDE_KMS_PM_SUSPEND_SNAPSHOT: duplicating the current atomic state
+ * @SDE_KMS_PM_SUSPEND_DISABLE: committing the "disable all" state
+ * @SDE_KMS_PM_SUSPEND_IDLE: waiting for pending work and going idle
+ * @SDE_KMS_PM_RESUME_RESET: resetting the software state
+ * @SDE_KMS_PM_RESUME_RESTORE: committing the saved state
+ * @SDE_KMS_PM_RESUME_FAST: resume without restore commit
+ */
+enum sde_kms_pm_phase {
+	SDE_KMS_PM_SUSPEND_SNAPSHOT,
+	SDE_KMS_PM_SUSPEND_DISABLE,
+	SDE_KMS_PM_SUSPEND_IDLE,
+	SDE_KMS_PM_RESUME_RESET,
+	SDE_KMS_PM_RESUME_RESTORE,
+	SDE_KMS_PM_RESUME_FAST,
+	SDE_KMS_PM_PHASE_MAX
+};
+
+/* bucket n counts latencies in [2^(n-1), 2^n) us, the last one is open */
+#define SDE_KMS_PM_HIST_BUCKETS	20
+
+/**
+ * struct sde_kms_pm_hist - latency histogram of one pm phase
+ * @buckets: log2 latency buckets in us
+ * @count: number of samples
+ * @last_us: latest sample
+ * @max_us: largest sample
+ */
+struct sde_kms_pm_hist {
+	u32 buckets[SDE_KMS_PM_HIST_BUCKETS];
+	u32 count;
+	u64 last_us;
+	u64 max_us;
+};
+
+/**
+ * struct sde_kms_pm_snapshot - summary of the state saved on pm suspend
+ * @valid: snapshot taken by the last suspend
+ * @idle: no crtc was enabled in the saved state
+ * @commit_count: commit count at the time of the snapshot
+ */
+struct sde_kms_pm_snapshot {
+	bool valid;
+	bool idle;
+	u32 commit_count;
+};
+
 struct sde_kms {
 	struct msm_kms base;
 	struct drm_device *dev;
@@ -269,6 +317,9 @@ struct sde_kms {
 	/* saved atomic state during system suspend */
 	struct drm_atomic_state *suspend_state;
 	bool suspend_block;
+	struct sde_kms_pm_snapshot pm_snapshot;
+	struct sde_kms_pm_hist pm_hist[SDE_KMS_PM_PHASE_MAX];
+	u32 commit_count;
 
 	struct sde_rm rm;
 	bool rm_init;
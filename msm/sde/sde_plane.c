@@ -419,9 +419,10 @@ end:
  * _sde_plane_set_ot_limit - set OT limit for the given plane
  * @plane:		Pointer to drm plane
  * @crtc:		Pointer to drm crtc
+ * @defer:		Queue a changed limit until the crtc flushes vbif
  */
 static void _sde_plane_set_ot_limit(struct drm_plane *plane,
-		struct drm_crtc *crtc)
+		struct drm_crtc *crtc, bool defer)
 {
 	struct sde_plane *psde;
 	struct sde_vbif_set_ot_params ot_params;
@@ -457,6 +458,7 @@ static void _sde_plane_set_ot_limit(struct drm_plane *plane,
 	ot_params.vbif_idx = VBIF_RT;
 	ot_params.clk_ctrl = psde->pipe_hw->cap->clk_ctrl;
 	ot_params.rd = true;
+	ot_params.defer = defer;
 
 	sde_vbif_set_ot_limit(sde_kms, &ot_params);
 }
@@ -1602,7 +1604,7 @@ void sde_plane_secure_ctrl_xin_client(struct drm_plane *plane,
 
 	/* do all VBIF programming for the sec-ui allowed SSPP */
 	_sde_plane_set_qos_remap(plane, true);
-	_sde_plane_set_ot_limit(plane, crtc);
+	_sde_plane_set_ot_limit(plane, crtc, false);
 }
 
 /**
@@ -3138,7 +3140,7 @@ static void _sde_plane_update_properties(struct drm_plane *plane,
 
 	if (plane->type != DRM_PLANE_TYPE_CURSOR) {
 		_sde_plane_set_qos_ctrl(plane, true, SDE_PLANE_QOS_PANIC_CTRL);
-		_sde_plane_set_ot_limit(plane, crtc);
+		_sde_plane_set_ot_limit(plane, crtc, true);
 		if (pstate->dirty & SDE_PLANE_DIRTY_PERF)
 			_sde_plane_set_ts_prefill(plane, pstate);
 	}
@@ -12,8 +12,6 @@
 #include "sde_trace.h"
 #include "sde_rotator_vbif.h"
 
-#define MAX_XIN_CLIENT	16
-
 /**
  * _sde_vbif_wait_for_xin_halt - wait for the xin to halt
  * @vbif:	Pointer to hardware vbif driver
@@ -165,13 +163,12 @@ static void _sde_vbif_apply_dynamic_ot_limit(struct sde_hw_vbif *vbif,
  * _sde_vbif_get_ot_limit - get OT based on usecase & configuration parameters
  * @vbif:	Pointer to hardware vbif driver
  * @params:	Pointer to usecase parameters
- * @return:	OT limit
+ * @return:	OT limit, 0 if the limit is not to be configured
  */
 static u32 _sde_vbif_get_ot_limit(struct sde_hw_vbif *vbif,
 	struct sde_vbif_set_ot_params *params)
 {
 	u32 ot_lim = 0;
-	u32 val;
 
 	if (!vbif || !vbif->cap) {
 		SDE_ERROR("invalid arguments vbif %d\n", !vbif);
@@ -193,33 +190,147 @@ static u32 _sde_vbif_get_ot_limit(struct sde_hw_vbif *vbif,
 	/* Modify the limits if the target and the use case requires it */
 	_sde_vbif_apply_dynamic_ot_limit(vbif, &ot_lim, params);
 
-	if (vbif && vbif->ops.get_limit_conf) {
-		val = vbif->ops.get_limit_conf(vbif,
-				params->xin_id, params->rd);
-		if (val == ot_lim)
-			ot_lim = 0;
-	}
-
 exit:
 	SDE_DEBUG("vbif:%d xin:%d ot_lim:%d\n",
 			vbif->idx - VBIF_0, params->xin_id, ot_lim);
 	return ot_lim;
 }
 
+/**
+ * _sde_vbif_get_cur_ot_limit - get the OT limit currently in hardware
+ *	The shadow copy is used when valid, otherwise it is refreshed from
+ *	the limit register.
+ * @vbif:	Pointer to hardware vbif driver
+ * @xin_id:	Client interface identifier
+ * @rd:		true for read limit; false for write limit
+ * @return:	current OT limit
+ */
+static u32 _sde_vbif_get_cur_ot_limit(struct sde_hw_vbif *vbif,
+		u32 xin_id, bool rd)
+{
+	struct sde_hw_vbif_shadow *shadow = &vbif->shadow;
+	u32 *valid = rd ? &shadow->ot_rd_valid : &shadow->ot_wr_valid;
+	u32 *ot = rd ? shadow->ot_rd : shadow->ot_wr;
+
+	if (!(*valid & BIT(xin_id))) {
+		ot[xin_id] = vbif->ops.get_limit_conf ?
+			vbif->ops.get_limit_conf(vbif, xin_id, rd) : 0;
+		*valid |= BIT(xin_id);
+	}
+
+	return ot[xin_id];
+}
+
+/**
+ * _sde_vbif_update_ot_shadow - record an OT limit written to hardware
+ * @vbif:	Pointer to hardware vbif driver
+ * @xin_id:	Client interface identifier
+ * @rd:		true for read limit; false for write limit
+ * @ot_lim:	OT limit written
+ */
+static void _sde_vbif_update_ot_shadow(struct sde_hw_vbif *vbif,
+		u32 xin_id, bool rd, u32 ot_lim)
+{
+	struct sde_hw_vbif_shadow *shadow = &vbif->shadow;
+
+	if (rd) {
+		shadow->ot_rd[xin_id] = ot_lim;
+		shadow->ot_rd_valid |= BIT(xin_id);
+	} else {
+		shadow->ot_wr[xin_id] = ot_lim;
+		shadow->ot_wr_valid |= BIT(xin_id);
+	}
+	vbif->stats.ot_updates++;
+}
+
+/**
+ * _sde_vbif_flush_pending - program the deferred OT limits of one vbif
+ *	All affected clients are halted before waiting on any of them, so
+ *	the halt latency is paid once per vbif rather than once per client.
+ *	Caller must hold the vbif mutex.
+ * @vbif:	Pointer to hardware vbif driver
+ * @mdp:	Pointer to hardware mdp top driver
+ */
+static void _sde_vbif_flush_pending(struct sde_hw_vbif *vbif,
+		struct sde_hw_mdp *mdp)
+{
+	struct sde_hw_vbif_pending *pending = &vbif->pending;
+	u32 xin_mask, forced_mask = 0;
+	int ret, i;
+
+	xin_mask = pending->rd_mask | pending->wr_mask;
+	if (!xin_mask)
+		return;
+
+	SDE_EVT32(vbif->idx, pending->rd_mask, pending->wr_mask);
+
+	for (i = 0; i < MAX_XIN_COUNT; i++) {
+		if (!(xin_mask & BIT(i)))
+			continue;
+
+		if (mdp->ops.setup_clk_force_ctrl(mdp,
+				pending->clk_ctrl[i], true))
+			forced_mask |= BIT(i);
+
+		if (pending->rd_mask & BIT(i)) {
+			vbif->ops.set_limit_conf(vbif, i, true,
+					pending->ot_rd[i]);
+			_sde_vbif_update_ot_shadow(vbif, i, true,
+					pending->ot_rd[i]);
+		}
+		if (pending->wr_mask & BIT(i)) {
+			vbif->ops.set_limit_conf(vbif, i, false,
+					pending->ot_wr[i]);
+			_sde_vbif_update_ot_shadow(vbif, i, false,
+					pending->ot_wr[i]);
+		}
+
+		vbif->ops.set_halt_ctrl(vbif, i, true);
+	}
+
+	for (i = 0; i < MAX_XIN_COUNT; i++) {
+		if (!(xin_mask & BIT(i)))
+			continue;
+
+		ret = _sde_vbif_wait_for_xin_halt(vbif, i);
+		if (ret)
+			SDE_EVT32(vbif->idx, i);
+		vbif->stats.halts++;
+	}
+
+	for (i = 0; i < MAX_XIN_COUNT; i++) {
+		if (!(xin_mask & BIT(i)))
+			continue;
+
+		vbif->ops.set_halt_ctrl(vbif, i, false);
+		if (forced_mask & BIT(i))
+			mdp->ops.setup_clk_force_ctrl(mdp,
+					pending->clk_ctrl[i], false);
+	}
+
+	if (hweight32(xin_mask) > 1)
+		vbif->stats.batches++;
+
+	pending->rd_mask = 0;
+	pending->wr_mask = 0;
+}
+
 /**
  * sde_vbif_set_ot_limit - set OT based on usecase & configuration parameters
  * @vbif:	Pointer to hardware vbif driver
  * @params:	Pointer to usecase parameters
  *
- * Note this function would block waiting for bus halt.
+ * Note this function would block waiting for bus halt, unless the limit
+ * is unchanged or the request is deferred.
  */
 void sde_vbif_set_ot_limit(struct sde_kms *sde_kms,
 		struct sde_vbif_set_ot_params *params)
 {
 	struct sde_hw_vbif *vbif = NULL;
+	struct sde_hw_vbif_pending *pending;
 	struct sde_hw_mdp *mdp;
 	bool forced_on = false;
-	u32 ot_lim;
+	u32 ot_lim, *pending_mask, *pending_ot;
 	int ret, i;
 
 	if (!sde_kms) {
@@ -253,31 +364,65 @@ void sde_vbif_set_ot_limit(struct sde_kms *sde_kms,
 			!vbif->ops.set_halt_ctrl)
 		return;
 
+	if (params->xin_id >= MAX_XIN_COUNT) {
+		SDE_ERROR("invalid xin %d\n", params->xin_id);
+		return;
+	}
+
 	mutex_lock(&vbif->mutex);
 
 	SDE_EVT32_VERBOSE(vbif->idx, params->xin_id);
 
 	/* set write_gather_en for all write clients */
-	if (vbif->ops.set_write_gather_en && !params->rd)
+	if (vbif->ops.set_write_gather_en && !params->rd &&
+			!(vbif->shadow.wr_gather_valid & BIT(params->xin_id))) {
 		vbif->ops.set_write_gather_en(vbif, params->xin_id);
+		vbif->shadow.wr_gather_valid |= BIT(params->xin_id);
+	}
 
 	ot_lim = _sde_vbif_get_ot_limit(vbif, params) & 0xFF;
 
 	if (ot_lim == 0)
 		goto exit;
 
+	pending = &vbif->pending;
+	pending_mask = params->rd ? &pending->rd_mask : &pending->wr_mask;
+	pending_ot = params->rd ? pending->ot_rd : pending->ot_wr;
+
+	if (ot_lim == _sde_vbif_get_cur_ot_limit(vbif, params->xin_id,
+				params->rd)) {
+		/* a queued change may have been reverted before the flush */
+		*pending_mask &= ~BIT(params->xin_id);
+		vbif->stats.halts_avoided++;
+		goto exit;
+	} else if ((*pending_mask & BIT(params->xin_id)) &&
+			pending_ot[params->xin_id] == ot_lim) {
+		vbif->stats.halts_avoided++;
+		goto exit;
+	}
+
 	trace_sde_perf_set_ot(params->num, params->xin_id, ot_lim,
 		params->vbif_idx);
 
+	if (params->defer) {
+		pending_ot[params->xin_id] = ot_lim;
+		pending->clk_ctrl[params->xin_id] = params->clk_ctrl;
+		*pending_mask |= BIT(params->xin_id);
+		goto exit;
+	}
+	*pending_mask &= ~BIT(params->xin_id);
+
 	forced_on = mdp->ops.setup_clk_force_ctrl(mdp, params->clk_ctrl, true);
 
 	vbif->ops.set_limit_conf(vbif, params->xin_id, params->rd, ot_lim);
+	_sde_vbif_update_ot_shadow(vbif, params->xin_id, params->rd, ot_lim);
 
 	vbif->ops.set_halt_ctrl(vbif, params->xin_id, true);
 
 	ret = _sde_vbif_wait_for_xin_halt(vbif, params->xin_id);
 	if (ret)
 		SDE_EVT32(vbif->idx, params->xin_id);
+	vbif->stats.halts++;
 
 	vbif->ops.set_halt_ctrl(vbif, params->xin_id, false);
 
@@ -287,6 +432,62 @@ exit:
 	mutex_unlock(&vbif->mutex);
 }
 
+void sde_vbif_flush_pending(struct sde_kms *sde_kms)
+{
+	struct sde_hw_vbif *vbif;
+	struct sde_hw_mdp *mdp;
+	bool allowed;
+	int i;
+
+	if (!sde_kms || !sde_kms->hw_mdp) {
+		SDE_ERROR("invalid arguments\n");
+		return;
+	}
+
+	mdp = sde_kms->hw_mdp;
+	allowed = sde_kms_is_vbif_operation_allowed(sde_kms) &&
+			mdp->ops.setup_clk_force_ctrl;
+
+	for (i = 0; i < ARRAY_SIZE(sde_kms->hw_vbif); i++) {
+		vbif = sde_kms->hw_vbif[i];
+		if (!vbif)
+			continue;
+
+		mutex_lock(&vbif->mutex);
+		if (allowed) {
+			_sde_vbif_flush_pending(vbif, mdp);
+		} else {
+			vbif->pending.rd_mask = 0;
+			vbif->pending.wr_mask = 0;
+		}
+		mutex_unlock(&vbif->mutex);
+	}
+}
+
+void sde_vbif_invalidate_state(struct sde_kms *sde_kms)
+{
+	struct sde_hw_vbif *vbif;
+	int i;
+
+	if (!sde_kms) {
+		SDE_ERROR("invalid argument\n");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(sde_kms->hw_vbif); i++) {
+		vbif = sde_kms->hw_vbif[i];
+		if (!vbif)
+			continue;
+
+		mutex_lock(&vbif->mutex);
+		vbif->shadow.ot_rd_valid = 0;
+		vbif->shadow.ot_wr_valid = 0;
+		vbif->shadow.wr_gather_valid = 0;
+		vbif->shadow.qos_valid = 0;
+		mutex_unlock(&vbif->mutex);
+	}
+}
+
 void mdp_vbif_lock(struct platform_device *parent_pdev, bool enable)
 {
 	struct drm_device *ddev;
@@ -438,6 +639,15 @@ void sde_vbif_set_qos_remap(struct sde_kms *sde_kms,
 
 	mutex_lock(&vbif->mutex);
 
+	if (params->xin_id < MAX_XIN_COUNT &&
+			(vbif->shadow.qos_valid & BIT(params->xin_id)) &&
+			vbif->shadow.qos_client[params->xin_id] ==
+				params->client_type) {
+		vbif->stats.qos_skipped++;
+		mutex_unlock(&vbif->mutex);
+		return;
+	}
+
 	forced_on = mdp->ops.setup_clk_force_ctrl(mdp, params->clk_ctrl, true);
 
 	for (i = 0; i < qos_tbl->npriority_lvl; i++) {
@@ -448,6 +658,12 @@ void sde_vbif_set_qos_remap(struct sde_kms *sde_kms,
 				qos_tbl->priority_lvl[i]);
 	}
 
+	if (params->xin_id < MAX_XIN_COUNT) {
+		vbif->shadow.qos_client[params->xin_id] = params->client_type;
+		vbif->shadow.qos_valid |= BIT(params->xin_id);
+	}
+	vbif->stats.qos_updates++;
+
 	if (forced_on)
 		mdp->ops.setup_clk_force_ctrl(mdp, params->clk_ctrl, false);
 
@@ -529,7 +745,7 @@ int sde_vbif_halt_xin_mask(struct sde_kms *sde_kms, u32 xin_id_mask,
 
 	SDE_EVT32(xin_id_mask, halt);
 
-	for (i = 0; i < MAX_XIN_CLIENT; i++) {
+	for (i = 0; i < MAX_XIN_COUNT; i++) {
 		if (xin_id_mask & BIT(i)) {
 			/* unhalt the xin-clients */
 			if (!halt) {
@@ -578,12 +794,38 @@ int sde_debugfs_vbif_init(struct sde_kms *sde_kms, struct dentry *debugfs_root)
 
 	for (i = 0; i < sde_kms->catalog->vbif_count; i++) {
 		struct sde_vbif_cfg *vbif = &sde_kms->catalog->vbif[i];
+		struct sde_hw_vbif *hw_vbif = NULL;
 
 		snprintf(vbif_name, sizeof(vbif_name), "%d", vbif->id);
 
 		debugfs_vbif = debugfs_create_dir(vbif_name,
 				sde_kms->debugfs_vbif);
 
+		for (j = 0; j < ARRAY_SIZE(sde_kms->hw_vbif); j++) {
+			if (sde_kms->hw_vbif[j] &&
+					sde_kms->hw_vbif[j]->idx == vbif->id) {
+				hw_vbif = sde_kms->hw_vbif[j];
+				break;
+			}
+		}
+
+		if (hw_vbif) {
+			struct sde_hw_vbif_stats *stats = &hw_vbif->stats;
+
+			debugfs_create_u64("ot_updates", 0400, debugfs_vbif,
+				&stats->ot_updates);
+			debugfs_create_u64("halts", 0400, debugfs_vbif,
+				&stats->halts);
+			debugfs_create_u64("halts_avoided", 0400, debugfs_vbif,
+				&stats->halts_avoided);
+			debugfs_create_u64("batches", 0400, debugfs_vbif,
+				&stats->batches);
+			debugfs_create_u64("qos_updates", 0400, debugfs_vbif,
+				&stats->qos_updates);
+			debugfs_create_u64("qos_skipped", 0400, debugfs_vbif,
+				&stats->qos_skipped);
+		}
+
 		debugfs_create_u32("features", 0400, debugfs_vbif,
 			(u32 *)&vbif->features);
 
@@ -8,6 +8,19 @@
 
 #include "sde_kms.h"
 
+/**
+ * struct sde_vbif_set_ot_params - OT limit parameters
+ * @xin_id: client interface identifier
+ * @num: pipe identifier (debug only)
+ * @width: source width
+ * @height: source height
+ * @frame_rate: refresh rate
+ * @rd: true for read limit; false for write limit
+ * @is_wfd: true for writeback/wfd use case
+ * @vbif_idx: vbif identifier
+ * @clk_ctrl: clock control identifier of the xin
+ * @defer: queue a changed limit until sde_vbif_flush_pending is called
+ */
 struct sde_vbif_set_ot_params {
 	u32 xin_id;
 	u32 num;
@@ -18,6 +31,7 @@ struct sde_vbif_set_ot_params {
 	bool is_wfd;
 	u32 vbif_idx;
 	u32 clk_ctrl;
+	bool defer;
 };
 
 struct sde_vbif_set_memtype_params {
@@ -62,12 +76,29 @@ struct sde_vbif_set_qos_params {
 
 /**
  * sde_vbif_set_ot_limit - set OT limit for vbif client
+ *	Requests matching the last programmed limit are dropped without
+ *	touching the hardware.
  * @sde_kms:	SDE handler
  * @params:	Pointer to OT configuration parameters
  */
 void sde_vbif_set_ot_limit(struct sde_kms *sde_kms,
 		struct sde_vbif_set_ot_params *params);
 
+/**
+ * sde_vbif_flush_pending - program all deferred OT limits
+ *	Clients of each vbif are halted together and released once
+ *	every new limit is in place.
+ * @sde_kms:	SDE handler
+ */
+void sde_vbif_flush_pending(struct sde_kms *sde_kms);
+
+/**
+ * sde_vbif_invalidate_state - forget the last programmed client settings
+ *	Must be called whenever vbif registers may have lost their content.
+ * @sde_kms:	SDE handler
+ */
+void sde_vbif_invalidate_state(struct sde_kms *sde_kms);
+
 /**
  * sde_vbif_set_xin_halt - halt one of the xin ports
  *	This function isn't thread safe.
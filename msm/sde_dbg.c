@@ -15,6 +15,8 @@
 #include <linux/list_sort.h>
 #include <linux/pm.h>
 #include <linux/pm_runtime.h>
+#include <linux/vmalloc.h>
+#include <linux/io.h>
 
 #include "sde_dbg.h"
 #include "sde/sde_hw_catalog.h"
@@ -22,7 +24,7 @@
 #define SDE_DBG_BASE_MAX		10
 
 #define DEFAULT_PANIC		1
-#define DEFAULT_REGDUMP		SDE_DBG_DUMP_IN_MEM
+#define DEFAULT_REGDUMP		(SDE_DBG_DUMP_IN_MEM | SDE_DBG_DUMP_IN_SNAPSHOT)
 #define DEFAULT_DBGBUS_SDE	SDE_DBG_DUMP_IN_MEM
 #define DEFAULT_DBGBUS_VBIFRT	SDE_DBG_DUMP_IN_MEM
 #define DEFAULT_BASE_REG_CNT	0x100
@@ -76,6 +78,10 @@
 #define DUMP_LINE_SIZE			256
 #define DUMP_MAX_LINES_PER_BLK		512
 
+#define SNAPSHOT_BUF_SIZE		(4096 * 256)
+#define SNAPSHOT_MAGIC			0x53444552 /* "SDER" */
+#define SNAPSHOT_VERSION		1
+
 /**
  * struct sde_dbg_reg_offset - tracking for start and end of region
  * @start: start offset
@@ -194,6 +200,61 @@ struct sde_dbg_regbuf {
 	struct sde_dbg_reg_base *cur_blk;
 };
 
+/**
+ * struct sde_dbg_snapshot_hdr - binary register snapshot header
+ *	followed by @num_ranges range records, each trailed by its data
+ * @magic: SNAPSHOT_MAGIC
+ * @version: SNAPSHOT_VERSION
+ * @num_ranges: number of range records in the snapshot
+ * @len: valid bytes in the snapshot, including this header
+ * @timestamp: capture start time in ns
+ * @capture_ns: time spent reading registers in ns
+ */
+struct sde_dbg_snapshot_hdr {
+	u32 magic;
+	u32 version;
+	u32 num_ranges;
+	u32 len;
+	u64 timestamp;
+	u64 capture_ns;
+};
+
+/**
+ * struct sde_dbg_snapshot_range - binary register snapshot range record
+ * @blk_name: register base name
+ * @range_name: name of the dumped range
+ * @offset: start offset of the range from the register base
+ * @len: length in bytes of the register data following this record
+ */
+struct sde_dbg_snapshot_range {
+	char blk_name[RANGE_NAME_LEN];
+	char range_name[RANGE_NAME_LEN];
+	u32 offset;
+	u32 len;
+};
+
+/**
+ * struct sde_dbg_snapshot - binary register snapshot state
+ * @buf: preallocated snapshot buffer, starts with sde_dbg_snapshot_hdr
+ * @size: size of the snapshot buffer
+ * @blob: debugfs blob exposing the valid part of the last snapshot
+ * @log_work: work struct for deferred kernel log formatting
+ * @log_pending: whether the last snapshot still needs to be logged
+ * @capture_start: start time of the capture in progress
+ * @capture_ns: time spent reading registers for the last snapshot
+ * @overflow: ranges of the last dump that did not fit and were read directly
+ */
+struct sde_dbg_snapshot {
+	void *buf;
+	size_t size;
+	struct debugfs_blob_wrapper blob;
+	struct work_struct log_work;
+	bool log_pending;
+	ktime_t capture_start;
+	u64 capture_ns;
+	u32 overflow;
+};
+
 /**
  * struct sde_dbg_base - global sde debug base structure
  * @evtlog: event log instance
@@ -214,6 +275,7 @@ struct sde_dbg_regbuf {
  * @cur_evt_index: index used for tracking event logs dump in hw recovery
  * @dbgbus_dump_idx: index used for tracking dbg-bus dump in hw recovery
  * @vbif_dbgbus_dump_idx: index for tracking vbif dumps in hw recovery
+ * @snapshot: binary register snapshot state
  */
 static struct sde_dbg_base {
 	struct sde_dbg_evtlog *evtlog;
@@ -241,6 +303,8 @@ static struct sde_dbg_base {
 	u32 dbgbus_dump_idx;
 	u32 vbif_dbgbus_dump_idx;
 	enum sde_dbg_dump_context dump_mode;
+
+	struct sde_dbg_snapshot snapshot;
 } sde_dbg_base;
 
 /* sde_dbg_base_evtlog - global pointer to main sde event log for macro use */
@@ -2908,8 +2972,205 @@ static inline bool _sde_power_check(enum sde_dbg_dump_context dump_mode)
 		dump_mode == SDE_DBG_DUMP_IRQ_CTX) ? false : true;
 }
 
+/**
+ * _sde_dbg_snapshot_begin - reset the binary register snapshot for a new dump
+ * @snapshot: snapshot state
+ */
+static void _sde_dbg_snapshot_begin(struct sde_dbg_snapshot *snapshot)
+{
+	struct sde_dbg_snapshot_hdr *hdr = snapshot->buf;
+
+	/* buffer is allocated in sde_dbg_init, never during a dump */
+	if (!hdr)
+		return;
+
+	hdr->magic = SNAPSHOT_MAGIC;
+	hdr->version = SNAPSHOT_VERSION;
+	hdr->num_ranges = 0;
+	hdr->len = sizeof(*hdr);
+	hdr->timestamp = ktime_to_ns(ktime_get());
+	hdr->capture_ns = 0;
+
+	snapshot->blob.data = snapshot->buf;
+	snapshot->blob.size = 0;
+	snapshot->log_pending = false;
+	snapshot->capture_start = ktime_get();
+	snapshot->capture_ns = 0;
+	snapshot->overflow = 0;
+}
+
+/**
+ * _sde_dbg_snapshot_reg - bulk copy a register range into the snapshot
+ * @blk_name: register base name
+ * @range_name: register range name
+ * @base_addr: starting address of io region for calculating offsets
+ * @addr: starting address of the range
+ * @len_bytes: range of the register set
+ * @reg_dump_flag: dumping flag controlling in-log/memory dump location
+ * @dump_mem: output buffer for memory dump location option
+ * Return: true if the range was captured; false to fall back to a
+ *	register by register dump
+ */
+static bool _sde_dbg_snapshot_reg(const char *blk_name,
+		const char *range_name, char *base_addr, char *addr,
+		size_t len_bytes, u32 reg_dump_flag, u32 **dump_mem)
+{
+	struct sde_dbg_snapshot *snapshot = &sde_dbg_base.snapshot;
+	struct sde_dbg_snapshot_hdr *hdr = snapshot->buf;
+	struct sde_dbg_snapshot_range *range;
+	u32 len, len_padded;
+	ktime_t start;
+	int rc;
+
+	if (!hdr)
+		return false;
+
+	len = round_up(len_bytes, sizeof(u32));
+	if (hdr->len + sizeof(*range) + len > snapshot->size) {
+		snapshot->overflow++;
+		return false;
+	}
+
+	range = snapshot->buf + hdr->len;
+	strlcpy(range->blk_name, blk_name, sizeof(range->blk_name));
+	strlcpy(range->range_name, range_name, sizeof(range->range_name));
+	range->offset = addr - base_addr;
+	range->len = len;
+
+	if (_sde_power_check(sde_dbg_base.dump_mode)) {
+		rc = pm_runtime_get_sync(sde_dbg_base.dev);
+		if (rc < 0) {
+			pr_err("failed to enable power %d\n", rc);
+			return true;
+		}
+	}
+
+	start = ktime_get();
+	__ioread32_copy(range + 1, addr, len / sizeof(u32));
+	snapshot->capture_ns += ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	if (_sde_power_check(sde_dbg_base.dump_mode))
+		pm_runtime_put_sync(sde_dbg_base.dev);
+
+	hdr->num_ranges++;
+	hdr->len += sizeof(*range) + len;
+
+	if (reg_dump_flag & SDE_DBG_DUMP_IN_LOG)
+		snapshot->log_pending = true;
+
+	if ((reg_dump_flag & SDE_DBG_DUMP_IN_MEM) && dump_mem) {
+		len_padded = round_up(len_bytes, REG_DUMP_ALIGN);
+		if (!(*dump_mem)) {
+			phys_addr_t phys = 0;
+			*dump_mem = dma_alloc_coherent(sde_dbg_base.dev,
+					len_padded, &phys, GFP_KERNEL);
+		}
+
+		if (*dump_mem) {
+			memcpy(*dump_mem, range + 1, len);
+			memset((char *)*dump_mem + len, 0, len_padded - len);
+		}
+	}
+
+	return true;
+}
+
+static void _sde_dbg_snapshot_log(struct sde_dbg_snapshot *snapshot);
+
+/**
+ * _sde_dbg_snapshot_end - publish the binary register snapshot
+ * @snapshot: snapshot state
+ * @sync: format into the kernel log before returning
+ *
+ * Formatting into the kernel log is deferred to a worker so that the
+ * capture itself does not stall on printk, unless the caller is about to
+ * panic and the worker would never run.
+ */
+static void _sde_dbg_snapshot_end(struct sde_dbg_snapshot *snapshot,
+		bool sync)
+{
+	struct sde_dbg_snapshot_hdr *hdr = snapshot->buf;
+
+	if (!hdr)
+		return;
+
+	hdr->capture_ns = snapshot->capture_ns;
+	snapshot->blob.size = hdr->len;
+
+	dev_info(sde_dbg_base.dev,
+		"reg snapshot: %u ranges %u bytes, capture %llu us total %lld us overflow %u\n",
+		hdr->num_ranges, hdr->len,
+		div_u64(snapshot->capture_ns, NSEC_PER_USEC),
+		ktime_us_delta(ktime_get(), snapshot->capture_start),
+		snapshot->overflow);
+
+	if (!snapshot->log_pending)
+		return;
+
+	if (sync)
+		_sde_dbg_snapshot_log(snapshot);
+	else
+		schedule_work(&snapshot->log_work);
+}
+
+/**
+ * _sde_dbg_snapshot_log - format the snapshot into the kernel log
+ * @snapshot: snapshot state
+ *
+ * Must be called with sde_dbg_base.mutex held.
+ */
+static void _sde_dbg_snapshot_log(struct sde_dbg_snapshot *snapshot)
+{
+	struct sde_dbg_snapshot_hdr *hdr = snapshot->buf;
+	struct sde_dbg_snapshot_range *range;
+	u32 *data, i, j, pos;
+	u32 x[4];
+
+	if (!hdr || !snapshot->log_pending)
+		return;
+
+	pos = sizeof(*hdr);
+	for (i = 0; i < hdr->num_ranges; i++) {
+		range = snapshot->buf + pos;
+		data = (u32 *)(range + 1);
+
+		dev_info(sde_dbg_base.dev, "%s: %s start_offset 0x%x len 0x%x\n",
+				range->blk_name, range->range_name,
+				range->offset, range->len);
+
+		for (j = 0; j < range->len / sizeof(u32); j += 4) {
+			memset(x, 0, sizeof(x));
+			memcpy(x, data + j, min_t(u32, sizeof(x),
+					range->len - j * sizeof(u32)));
+			dev_info(sde_dbg_base.dev,
+					"0x%lx : %08x %08x %08x %08x\n",
+					(unsigned long)(range->offset +
+					j * sizeof(u32)),
+					x[0], x[1], x[2], x[3]);
+		}
+
+		pos += sizeof(*range) + range->len;
+	}
+	snapshot->log_pending = false;
+}
+
+/**
+ * _sde_dbg_snapshot_log_work - deferred kernel log formatting of snapshot
+ * @work: work structure
+ */
+static void _sde_dbg_snapshot_log_work(struct work_struct *work)
+{
+	struct sde_dbg_snapshot *snapshot = container_of(work,
+			struct sde_dbg_snapshot, log_work);
+
+	mutex_lock(&sde_dbg_base.mutex);
+	_sde_dbg_snapshot_log(snapshot);
+	mutex_unlock(&sde_dbg_base.mutex);
+}
+
 /**
  * _sde_dump_reg - helper function for dumping rotator register set content
+ * @blk_name: register base name
  * @dump_name: register set name
  * @reg_dump_flag: dumping flag controlling in-log/memory dump location
  * @base_addr: starting address of io region for calculating offsets to print
@@ -2918,8 +3179,9 @@ static inline bool _sde_power_check(enum sde_dbg_dump_context dump_mode)
  * @dump_mem: output buffer for memory dump location option
  * @from_isr: whether being called from isr context
  */
-static void _sde_dump_reg(const char *dump_name, u32 reg_dump_flag,
-		char *base_addr, char *addr, size_t len_bytes, u32 **dump_mem)
+static void _sde_dump_reg(const char *blk_name, const char *dump_name,
+		u32 reg_dump_flag, char *base_addr, char *addr,
+		size_t len_bytes, u32 **dump_mem)
 {
 	u32 in_log, in_mem, len_align, len_padded;
 	u32 *dump_addr = NULL;
@@ -2939,6 +3201,11 @@ static void _sde_dump_reg(const char *dump_name, u32 reg_dump_flag,
 	if (!in_log && !in_mem)
 		return;
 
+	if ((reg_dump_flag & SDE_DBG_DUMP_IN_SNAPSHOT) &&
+			_sde_dbg_snapshot_reg(blk_name, dump_name, base_addr,
+				addr, len_bytes, reg_dump_flag, dump_mem))
+		return;
+
 	if (in_log)
 		dev_info(sde_dbg_base.dev, "%s: start_offset 0x%lx len 0x%zx\n",
 				dump_name, (unsigned long)(addr - base_addr),
@@ -3100,8 +3367,8 @@ static void _sde_dump_reg_by_ranges(struct sde_dbg_reg_base *dbg,
 				addr, range_node->offset.start,
 				range_node->offset.end);
 
-			_sde_dump_reg(range_node->range_name, reg_dump_flag,
-					dbg->base, addr, len,
+			_sde_dump_reg(dbg->name, range_node->range_name,
+					reg_dump_flag, dbg->base, addr, len,
 					&range_node->reg_dump);
 		}
 	} else {
@@ -3112,8 +3379,8 @@ static void _sde_dump_reg_by_ranges(struct sde_dbg_reg_base *dbg,
 				dbg->max_offset);
 		addr = dbg->base;
 		len = dbg->max_offset;
-		_sde_dump_reg(dbg->name, reg_dump_flag, dbg->base, addr, len,
-				&dbg->reg_dump);
+		_sde_dump_reg(dbg->name, dbg->name, reg_dump_flag, dbg->base,
+				addr, len, &dbg->reg_dump);
 	}
 }
 
@@ -3484,6 +3751,9 @@ static void _sde_dump_array(struct sde_dbg_reg_base *blk_arr[],
 	if (dump_all)
 		sde_evtlog_dump_all(sde_dbg_base.evtlog);
 
+	if (sde_dbg_base.enable_reg_dump & SDE_DBG_DUMP_IN_SNAPSHOT)
+		_sde_dbg_snapshot_begin(&sde_dbg_base.snapshot);
+
 	if (dump_all || !blk_arr || !len) {
 		_sde_dump_reg_all(dump_secure);
 	} else {
@@ -3495,6 +3765,10 @@ static void _sde_dump_array(struct sde_dbg_reg_base *blk_arr[],
 		}
 	}
 
+	if (sde_dbg_base.enable_reg_dump & SDE_DBG_DUMP_IN_SNAPSHOT)
+		_sde_dbg_snapshot_end(&sde_dbg_base.snapshot,
+				do_panic && sde_dbg_base.panic_on_err);
+
 	if (dump_dbgbus_sde)
 		_sde_dbg_dump_sde_dbg_bus(&sde_dbg_base.dbgbus_sde);
 
@@ -4566,6 +4840,10 @@ int sde_dbg_debugfs_register(struct device *dev)
 			&sde_dbg_base.enable_reg_dump);
 	debugfs_create_file("recovery_reg", 0400, debugfs_root, NULL,
 			&sde_recovery_reg_fops);
+	debugfs_create_blob("reg_snapshot", 0400, debugfs_root,
+			&sde_dbg_base.snapshot.blob);
+	debugfs_create_u64("reg_snapshot_capture_ns", 0400, debugfs_root,
+			&sde_dbg_base.snapshot.capture_ns);
 	debugfs_create_file("recovery_dbgbus", 0400, debugfs_root, NULL,
 			&sde_recovery_dbgbus_fops);
 	debugfs_create_file("recovery_vbif_dbgbus", 0400, debugfs_root, NULL,
@@ -4666,6 +4944,12 @@ int sde_dbg_init(struct device *dev)
 	sde_dbg_base_evtlog = sde_dbg_base.evtlog;
 
 	INIT_WORK(&sde_dbg_base.dump_work, _sde_dump_work);
+	INIT_WORK(&sde_dbg_base.snapshot.log_work, _sde_dbg_snapshot_log_work);
+	sde_dbg_base.snapshot.buf = vzalloc(SNAPSHOT_BUF_SIZE);
+	if (sde_dbg_base.snapshot.buf)
+		sde_dbg_base.snapshot.size = SNAPSHOT_BUF_SIZE;
+	else
+		pr_err("failed to allocate register snapshot\n");
 	sde_dbg_base.work_panic = false;
 	sde_dbg_base.panic_on_err = DEFAULT_PANIC;
 	sde_dbg_base.enable_reg_dump = DEFAULT_REGDUMP;
@@ -4705,6 +4989,9 @@ void sde_dbg_destroy(void)
 {
 	kfree(sde_dbg_base.regbuf.buf);
 	memset(&sde_dbg_base.regbuf, 0, sizeof(sde_dbg_base.regbuf));
+	cancel_work_sync(&sde_dbg_base.snapshot.log_work);
+	vfree(sde_dbg_base.snapshot.buf);
+	memset(&sde_dbg_base.snapshot, 0, sizeof(sde_dbg_base.snapshot));
 	_sde_dbg_debugfs_destroy();
 	sde_dbg_base_evtlog = NULL;
 	sde_evtlog_destroy(sde_dbg_base.evtlog);
@@ -0,0 +1,525 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ */
+
+#define pr_fmt(fmt)	"[drm:%s:%d] " fmt, __func__, __LINE__
+
+#include <linux/kernel.h>
+#include <linux/spinlock.h>
+
+#include "sde_dsc_helper.h"
+
+#define SDE_DSC_RC_RANGES		15
+#define SDE_DSC_RC_BUF_THRESH		14
+#define SDE_DSC_CACHE_SIZE		8
+
+enum sde_dsc_ratio_type {
+	DSC_8BPC_8BPP,
+	DSC_10BPC_8BPP,
+	DSC_12BPC_8BPP,
+	DSC_10BPC_10BPP,
+	DSC_RATIO_TYPE_MAX
+};
+
+static u32 sde_dsc_rc_buf_thresh[SDE_DSC_RC_BUF_THRESH] = {0x0e, 0x1c, 0x2a,
+		0x38, 0x46, 0x54, 0x62, 0x69, 0x70, 0x77, 0x79, 0x7b, 0x7d,
+		0x7e};
+
+/*
+ * DSC 1.1
+ * Rate control - Min QP values for each ratio type in sde_dsc_ratio_type
+ */
+static char sde_dsc_rc_range_min_qp_1_1[][DSC_RATIO_TYPE_MAX]
+		[SDE_DSC_RC_RANGES] = {
+	[SDE_DSC_RC_PROFILE_DSI] = {
+		{0, 0, 1, 1, 3, 3, 3, 3, 3, 3, 5, 5, 5, 7, 12},
+		{0, 4, 5, 5, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 17},
+		{0, 4, 9, 9, 11, 11, 11, 11, 11, 11, 13, 13, 13, 15, 21},
+		{0, 4, 5, 6, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 15},
+	},
+	[SDE_DSC_RC_PROFILE_DP] = {
+		{0, 0, 1, 1, 3, 3, 3, 3, 3, 3, 5, 5, 5, 7, 13},
+		{0, 4, 5, 5, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 17},
+		{0, 4, 9, 9, 11, 11, 11, 11, 11, 11, 13, 13, 13, 15, 21},
+		{0, 4, 5, 6, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 15},
+	},
+};
+
+/*
+ * DSC 1.1 SCR
+ * Rate control - Min QP values for each ratio type in sde_dsc_ratio_type
+ */
+static char sde_dsc_rc_range_min_qp_1_1_scr1[][DSC_RATIO_TYPE_MAX]
+		[SDE_DSC_RC_RANGES] = {
+	[SDE_DSC_RC_PROFILE_DSI] = {
+		{0, 0, 1, 1, 3, 3, 3, 3, 3, 3, 5, 5, 5, 9, 12},
+		{0, 4, 5, 5, 7, 7, 7, 7, 7, 7, 9, 9, 9, 13, 16},
+		{0, 4, 9, 9, 11, 11, 11, 11, 11, 11, 13, 13, 13, 17, 20},
+		{0, 4, 5, 6, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 15},
+	},
+	[SDE_DSC_RC_PROFILE_DP] = {
+		{0, 0, 1, 1, 3, 3, 3, 3, 3, 3, 5, 5, 5, 9, 12},
+		{0, 4, 5, 5, 7, 7, 7, 7, 7, 7, 9, 9, 9, 13, 16},
+		{0, 4, 9, 9, 11, 11, 11, 11, 11, 11, 13, 13, 13, 17, 20},
+		{0, 4, 5, 6, 7, 7, 7, 7, 7, 7, 9, 9, 9, 11, 15},
+	},
+};
+
+/*
+ * DSC 1.1
+ * Rate control - Max QP values for each ratio type in sde_dsc_ratio_type
+ */
+static char sde_dsc_rc_range_max_qp_1_1[][DSC_RATIO_TYPE_MAX]
+		[SDE_DSC_RC_RANGES] = {
+	[SDE_DSC_RC_PROFILE_DSI] = {
+		{4, 4, 5, 6, 7, 7, 7, 8, 9, 10, 11, 12, 13, 13, 15},
+		{4, 8, 9, 10, 11, 11, 11, 12, 13, 14, 15, 16, 17, 17, 19},
+		{12, 12, 13, 14, 15, 15, 15, 16, 17, 18, 19, 20, 21, 21, 23},
+		{7, 8, 9, 10, 11, 11, 11, 12, 13, 13, 14, 14, 15, 15, 16},
+	},
+	[SDE_DSC_RC_PROFILE_DP] = {
+		{4, 4, 5, 6, 7, 7, 7, 8, 9, 10, 11, 12, 13, 13, 15},
+		{8, 8, 9, 10, 11, 11, 11, 12, 13, 14, 15, 16, 17, 17, 19},
+		{12, 12, 13, 14, 15, 15, 15, 16, 17, 18, 19, 20, 21, 21, 23},
+		{7, 8, 9, 10, 11, 11, 11, 12, 13, 13, 14, 14, 15, 15, 16},
+	},
+};
+
+/*
+ * DSC 1.1 SCR
+ * Rate control - Max QP values for each ratio type in sde_dsc_ratio_type
+ */
+static char sde_dsc_rc_range_max_qp_1_1_scr1[][DSC_RATIO_TYPE_MAX]
+		[SDE_DSC_RC_RANGES] = {
+	[SDE_DSC_RC_PROFILE_DSI] = {
+		{4, 4, 5, 6, 7, 7, 7, 8, 9, 10, 10, 11, 11, 12, 13},
+		{8, 8, 9, 10, 11, 11, 11, 12, 13, 14, 14, 15, 15, 16, 17},
+		{12, 12, 13, 14, 15, 15, 15, 16, 17, 18, 18, 19, 19, 20, 23},
+		{7, 8, 9, 10, 11, 11, 11, 12, 13, 13, 14, 14, 15, 15, 16},
+	},
+	[SDE_DSC_RC_PROFILE_DP] = {
+		{4, 4, 5, 6, 7, 7, 7, 8, 9, 10, 10, 11, 11, 12, 13},
+		{8, 8, 9, 10, 11, 11, 11, 12, 13, 14, 14, 15, 15, 16, 17},
+		{12, 12, 13, 14, 15, 15, 15, 16, 17, 18, 18, 19, 19, 20, 21},
+		{7, 8, 9, 10, 11, 11, 11, 12, 13, 13, 14, 14, 15, 15, 16},
+	},
+};
+
+/*
+ * DSC 1.1 and DSC 1.1 SCR
+ * Rate control - bpg offset values
+ */
+static char sde_dsc_rc_range_bpg_offset[SDE_DSC_RC_RANGES] = {2, 0, 0, -2,
+		-4, -6, -8, -8, -8, -10, -10, -12, -12, -12, -12};
+
+/**
+ * struct sde_dsc_rc_key - inputs the derived dsc parameters depend on
+ */
+struct sde_dsc_rc_key {
+	enum sde_dsc_rc_profile profile;
+	u8 version;
+	u8 scr_rev;
+	int bpc;
+	int bpp;
+	int slice_width;
+	int slice_height;
+	int line_buf_depth;
+};
+
+/**
+ * struct sde_dsc_rc_params - derived dsc parameters for one key
+ */
+struct sde_dsc_rc_params {
+	int rc_model_size;
+	int first_line_bpg_offset;
+	int edge_factor;
+	int tgt_offset_hi;
+	int tgt_offset_lo;
+	int enable_422;
+	int convert_rgb;
+	int vbr_enable;
+	u32 *buf_thresh;
+	char *range_min_qp;
+	char *range_max_qp;
+	char *range_bpg_offset;
+	int initial_offset;
+	int initial_xmit_delay;
+	int line_buf_depth;
+	int input_10_bits;
+	int min_qp_flatness;
+	int max_qp_flatness;
+	int quant_incr_limit0;
+	int quant_incr_limit1;
+	int slice_last_group_size;
+	int det_thresh_flatness;
+	int chunk_size;
+	int initial_dec_delay;
+	int initial_scale_value;
+	int nfl_bpg_offset;
+	int slice_bpg_offset;
+	int final_offset;
+	int scale_increment_interval;
+	int scale_decrement_interval;
+};
+
+struct sde_dsc_cache_entry {
+	bool valid;
+	struct sde_dsc_rc_key key;
+	struct sde_dsc_rc_params params;
+};
+
+static struct sde_dsc_cache_entry sde_dsc_cache[SDE_DSC_CACHE_SIZE];
+static u32 sde_dsc_cache_next;
+static DEFINE_SPINLOCK(sde_dsc_cache_lock);
+
+static void _sde_dsc_calc_params(const struct sde_dsc_rc_key *key,
+		struct sde_dsc_rc_params *p)
+{
+	int bpp = key->bpp, bpc = key->bpc;
+	int mux_words_size;
+	int groups_per_line, groups_total;
+	int min_rate_buffer_size;
+	int hrd_delay;
+	int pre_num_extra_mux_bits, num_extra_mux_bits;
+	int slice_bits;
+	int data;
+	int final_value, final_scale;
+	int ratio_index, mod_offset;
+	bool scr1 = (key->version == 0x11 && key->scr_rev == 0x1);
+
+	p->rc_model_size = 8192;
+	p->first_line_bpg_offset = scr1 ? 15 : 12;
+	p->edge_factor = 6;
+	p->tgt_offset_hi = 3;
+	p->tgt_offset_lo = 3;
+	p->enable_422 = 0;
+	p->convert_rgb = 1;
+	p->vbr_enable = 0;
+
+	p->buf_thresh = sde_dsc_rc_buf_thresh;
+
+	if ((bpc == 12) && (bpp == 8))
+		ratio_index = DSC_12BPC_8BPP;
+	else if ((bpc == 10) && (bpp == 8))
+		ratio_index = DSC_10BPC_8BPP;
+	else if ((bpc == 10) && (bpp == 10))
+		ratio_index = DSC_10BPC_10BPP;
+	else
+		ratio_index = DSC_8BPC_8BPP;
+
+	if (scr1) {
+		p->range_min_qp = sde_dsc_rc_range_min_qp_1_1_scr1
+				[key->profile][ratio_index];
+		p->range_max_qp = sde_dsc_rc_range_max_qp_1_1_scr1
+				[key->profile][ratio_index];
+	} else {
+		p->range_min_qp = sde_dsc_rc_range_min_qp_1_1
+				[key->profile][ratio_index];
+		p->range_max_qp = sde_dsc_rc_range_max_qp_1_1
+				[key->profile][ratio_index];
+	}
+	p->range_bpg_offset = sde_dsc_rc_range_bpg_offset;
+
+	if (bpp == 8) {
+		p->initial_offset = 6144;
+		p->initial_xmit_delay = 512;
+	} else if (bpp == 10) {
+		p->initial_offset = 5632;
+		p->initial_xmit_delay = 410;
+	} else {
+		p->initial_offset = 2048;
+		p->initial_xmit_delay = 341;
+	}
+
+	p->line_buf_depth = key->line_buf_depth;
+
+	if (bpc == 8) {
+		p->input_10_bits = 0;
+		p->min_qp_flatness = 3;
+		p->max_qp_flatness = 12;
+		p->quant_incr_limit0 = 11;
+		p->quant_incr_limit1 = 11;
+		mux_words_size = 48;
+	} else if (bpc == 10) { /* 10bpc */
+		p->input_10_bits = 1;
+		p->min_qp_flatness = 7;
+		p->max_qp_flatness = 16;
+		p->quant_incr_limit0 = 15;
+		p->quant_incr_limit1 = 15;
+		mux_words_size = 48;
+	} else { /* 12 bpc */
+		p->input_10_bits = 0;
+		p->min_qp_flatness = 11;
+		p->max_qp_flatness = 20;
+		p->quant_incr_limit0 = 19;
+		p->quant_incr_limit1 = 19;
+		mux_words_size = 64;
+	}
+
+	mod_offset = key->slice_width % 3;
+	switch (mod_offset) {
+	case 0:
+		p->slice_last_group_size = 2;
+		break;
+	case 1:
+		p->slice_last_group_size = 0;
+		break;
+	case 2:
+		p->slice_last_group_size = 1;
+		break;
+	default:
+		break;
+	}
+
+	p->det_thresh_flatness = 2 << (bpc - 8);
+
+	groups_per_line = DIV_ROUND_UP(key->slice_width, 3);
+
+	p->chunk_size = key->slice_width * bpp / 8;
+	if ((key->slice_width * bpp) % 8)
+		p->chunk_size++;
+
+	/* rbs-min */
+	min_rate_buffer_size =  p->rc_model_size - p->initial_offset +
+			p->initial_xmit_delay * bpp +
+			groups_per_line * p->first_line_bpg_offset;
+
+	hrd_delay = DIV_ROUND_UP(min_rate_buffer_size, bpp);
+
+	p->initial_dec_delay = hrd_delay - p->initial_xmit_delay;
+
+	p->initial_scale_value = 8 * p->rc_model_size /
+			(p->rc_model_size - p->initial_offset);
+
+	slice_bits = 8 * p->chunk_size * key->slice_height;
+
+	groups_total = groups_per_line * key->slice_height;
+
+	data = p->first_line_bpg_offset * 2048;
+
+	p->nfl_bpg_offset = DIV_ROUND_UP(data, (key->slice_height - 1));
+
+	pre_num_extra_mux_bits = 3 * (mux_words_size + (4 * bpc + 4) - 2);
+
+	num_extra_mux_bits = pre_num_extra_mux_bits - (mux_words_size -
+		((slice_bits - pre_num_extra_mux_bits) % mux_words_size));
+
+	data = 2048 * (p->rc_model_size - p->initial_offset
+		+ num_extra_mux_bits);
+	p->slice_bpg_offset = DIV_ROUND_UP(data, groups_total);
+
+	data = p->initial_xmit_delay * bpp;
+	final_value =  p->rc_model_size - data + num_extra_mux_bits;
+
+	final_scale = 8 * p->rc_model_size /
+		(p->rc_model_size - final_value);
+
+	p->final_offset = final_value;
+
+	data = (final_scale - 9) * (p->nfl_bpg_offset +
+		p->slice_bpg_offset);
+	p->scale_increment_interval = (2048 * p->final_offset) / data;
+
+	p->scale_decrement_interval = groups_per_line /
+		(p->initial_scale_value - 8);
+}
+
+static void _sde_dsc_apply_params(struct msm_display_dsc_info *dsc,
+		const struct sde_dsc_rc_params *p)
+{
+	dsc->rc_model_size = p->rc_model_size;
+	dsc->first_line_bpg_offset = p->first_line_bpg_offset;
+	dsc->edge_factor = p->edge_factor;
+	dsc->tgt_offset_hi = p->tgt_offset_hi;
+	dsc->tgt_offset_lo = p->tgt_offset_lo;
+	dsc->enable_422 = p->enable_422;
+	dsc->convert_rgb = p->convert_rgb;
+	dsc->vbr_enable = p->vbr_enable;
+	dsc->buf_thresh = p->buf_thresh;
+	dsc->range_min_qp = p->range_min_qp;
+	dsc->range_max_qp = p->range_max_qp;
+	dsc->range_bpg_offset = p->range_bpg_offset;
+	dsc->initial_offset = p->initial_offset;
+	dsc->initial_xmit_delay = p->initial_xmit_delay;
+	dsc->line_buf_depth = p->line_buf_depth;
+	dsc->input_10_bits = p->input_10_bits;
+	dsc->min_qp_flatness = p->min_qp_flatness;
+	dsc->max_qp_flatness = p->max_qp_flatness;
+	dsc->quant_incr_limit0 = p->quant_incr_limit0;
+	dsc->quant_incr_limit1 = p->quant_incr_limit1;
+	dsc->slice_last_group_size = p->slice_last_group_size;
+	dsc->det_thresh_flatness = p->det_thresh_flatness;
+	dsc->chunk_size = p->chunk_size;
+	dsc->initial_dec_delay = p->initial_dec_delay;
+	dsc->initial_scale_value = p->initial_scale_value;
+	dsc->nfl_bpg_offset = p->nfl_bpg_offset;
+	dsc->slice_bpg_offset = p->slice_bpg_offset;
+	dsc->final_offset = p->final_offset;
+	dsc->scale_increment_interval = p->scale_increment_interval;
+	dsc->scale_decrement_interval = p->scale_decrement_interval;
+}
+
+int sde_dsc_populate_dsc_config(struct msm_display_dsc_info *dsc,
+		enum sde_dsc_rc_profile profile, int line_buf_depth_max)
+{
+	struct sde_dsc_rc_key key;
+	struct sde_dsc_rc_params params;
+	struct sde_dsc_cache_entry *entry;
+	unsigned long flags;
+	u32 i;
+
+	if (!dsc || profile >= SDE_DSC_RC_PROFILE_MAX) {
+		pr_err("invalid input dsc %pK profile %d\n", dsc, profile);
+		return -EINVAL;
+	}
+
+	if (dsc->bpc < 8 || dsc->bpp <= 0 || dsc->slice_width <= 0 ||
+			dsc->slice_height <= 1) {
+		pr_err("invalid dsc config bpc %d bpp %d slice %dx%d\n",
+			dsc->bpc, dsc->bpp, dsc->slice_width,
+			dsc->slice_height);
+		return -EINVAL;
+	}
+
+	memset(&key, 0, sizeof(key));
+	key.profile = profile;
+	key.version = dsc->version;
+	key.scr_rev = dsc->scr_rev;
+	key.bpc = dsc->bpc;
+	key.bpp = dsc->bpp;
+	key.slice_width = dsc->slice_width;
+	key.slice_height = dsc->slice_height;
+	key.line_buf_depth = dsc->bpc + 1;
+	if (line_buf_depth_max)
+		key.line_buf_depth = min(line_buf_depth_max,
+				key.line_buf_depth);
+
+	spin_lock_irqsave(&sde_dsc_cache_lock, flags);
+	for (i = 0; i < SDE_DSC_CACHE_SIZE; i++) {
+		entry = &sde_dsc_cache[i];
+		if (entry->valid && !memcmp(&entry->key, &key, sizeof(key))) {
+			params = entry->params;
+			spin_unlock_irqrestore(&sde_dsc_cache_lock, flags);
+			goto apply;
+		}
+	}
+	spin_unlock_irqrestore(&sde_dsc_cache_lock, flags);
+
+	_sde_dsc_calc_params(&key, &params);
+
+	spin_lock_irqsave(&sde_dsc_cache_lock, flags);
+	entry = &sde_dsc_cache[sde_dsc_cache_next];
+	sde_dsc_cache_next = (sde_dsc_cache_next + 1) % SDE_DSC_CACHE_SIZE;
+	entry->key = key;
+	entry->params = params;
+	entry->valid = true;
+	spin_unlock_irqrestore(&sde_dsc_cache_lock, flags);
+
+apply:
+	_sde_dsc_apply_params(dsc, &params);
+
+	return 0;
+}
+
+int sde_dsc_create_pps_buf_cmd(struct msm_display_dsc_info *dsc,
+		char *buf, int pps_id)
+{
+	char *bp = buf;
+	char data;
+	int i, bpp;
+
+	*bp++ = (dsc->version & 0xff);		/* pps0 */
+	*bp++ = (pps_id & 0xff);		/* pps1 */
+	bp++;					/* pps2, reserved */
+
+	data = dsc->line_buf_depth & 0x0f;
+	data |= ((dsc->bpc & 0xf) << 4);
+	*bp++ = data;				/* pps3 */
+
+	bpp = dsc->bpp;
+	bpp <<= 4;				/* 4 fraction bits */
+	data = (bpp >> 8);
+	data &= 0x03;				/* upper two bits */
+	data |= ((dsc->block_pred_enable & 0x1) << 5);
+	data |= ((dsc->convert_rgb & 0x1) << 4);
+	data |= ((dsc->enable_422 & 0x1) << 3);
+	data |= ((dsc->vbr_enable & 0x1) << 2);
+	*bp++ = data;				/* pps4 */
+	*bp++ = (bpp & 0xff);			/* pps5 */
+
+	*bp++ = ((dsc->pic_height >> 8) & 0xff); /* pps6 */
+	*bp++ = (dsc->pic_height & 0x0ff);	/* pps7 */
+	*bp++ = ((dsc->pic_width >> 8) & 0xff);	/* pps8 */
+	*bp++ = (dsc->pic_width & 0x0ff);	/* pps9 */
+
+	*bp++ = ((dsc->slice_height >> 8) & 0xff);/* pps10 */
+	*bp++ = (dsc->slice_height & 0x0ff);	/* pps11 */
+	*bp++ = ((dsc->slice_width >> 8) & 0xff); /* pps12 */
+	*bp++ = (dsc->slice_width & 0x0ff);	/* pps13 */
+
+	*bp++ = ((dsc->chunk_size >> 8) & 0xff);/* pps14 */
+	*bp++ = (dsc->chunk_size & 0x0ff);	/* pps15 */
+
+	*bp++ = (dsc->initial_xmit_delay >> 8) & 0x3; /* pps16, bit 0, 1 */
+	*bp++ = (dsc->initial_xmit_delay & 0xff);/* pps17 */
+
+	*bp++ = ((dsc->initial_dec_delay >> 8) & 0xff); /* pps18 */
+	*bp++ = (dsc->initial_dec_delay & 0xff);/* pps19 */
+
+	bp++;					/* pps20, reserved */
+
+	*bp++ = (dsc->initial_scale_value & 0x3f); /* pps21 */
+
+	*bp++ = ((dsc->scale_increment_interval >> 8) & 0xff); /* pps22 */
+	*bp++ = (dsc->scale_increment_interval & 0xff); /* pps23 */
+
+	*bp++ = ((dsc->scale_decrement_interval >> 8) & 0xf); /* pps24 */
+	*bp++ = (dsc->scale_decrement_interval & 0x0ff);/* pps25 */
+
+	bp++;					/* pps26, reserved */
+
+	*bp++ = (dsc->first_line_bpg_offset & 0x1f);/* pps27 */
+
+	*bp++ = ((dsc->nfl_bpg_offset >> 8) & 0xff);/* pps28 */
+	*bp++ = (dsc->nfl_bpg_offset & 0x0ff);	/* pps29 */
+	*bp++ = ((dsc->slice_bpg_offset >> 8) & 0xff);/* pps30 */
+	*bp++ = (dsc->slice_bpg_offset & 0x0ff);/* pps31 */
+
+	*bp++ = ((dsc->initial_offset >> 8) & 0xff);/* pps32 */
+	*bp++ = (dsc->initial_offset & 0x0ff);	/* pps33 */
+
+	*bp++ = ((dsc->final_offset >> 8) & 0xff);/* pps34 */
+	*bp++ = (dsc->final_offset & 0x0ff);	/* pps35 */
+
+	*bp++ = (dsc->min_qp_flatness & 0x1f);	/* pps36 */
+	*bp++ = (dsc->max_qp_flatness & 0x1f);	/* pps37 */
+
+	*bp++ = ((dsc->rc_model_size >> 8) & 0xff);/* pps38 */
+	*bp++ = (dsc->rc_model_size & 0x0ff);	/* pps39 */
+
+	*bp++ = (dsc->edge_factor & 0x0f);	/* pps40 */
+
+	*bp++ = (dsc->quant_incr_limit0 & 0x1f);	/* pps41 */
+	*bp++ = (dsc->quant_incr_limit1 & 0x1f);	/* pps42 */
+
+	data = ((dsc->tgt_offset_hi & 0xf) << 4);
+	data |= (dsc->tgt_offset_lo & 0x0f);
+	*bp++ = data;				/* pps43 */
+
+	for (i = 0; i < SDE_DSC_RC_BUF_THRESH; i++)
+		*bp++ = (dsc->buf_thresh[i] & 0xff); /* pps44 - pps57 */
+
+	for (i = 0; i < SDE_DSC_RC_RANGES; i++) { /* pps58 - pps87 */
+		data = (dsc->range_min_qp[i] & 0x1f);
+		data <<= 3;
+		data |= ((dsc->range_max_qp[i] >> 2) & 0x07);
+		*bp++ = data;
+		data = (dsc->range_max_qp[i] & 0x03);
+		data <<= 6;
+		data |= (dsc->range_bpg_offset[i] & 0x3f);
+		*bp++ = data;
+	}
+
+	return SDE_DSC_PPS_SIZE;
+}
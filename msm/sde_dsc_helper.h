@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ */
+
+#ifndef __SDE_DSC_HELPER_H__
+#define __SDE_DSC_HELPER_H__
+
+#include "msm_drv.h"
+
+#define SDE_DSC_PPS_SIZE	88
+
+/**
+ * enum sde_dsc_rc_profile - rate control table set to use
+ * @SDE_DSC_RC_PROFILE_DSI: tables tuned for DSI panels
+ * @SDE_DSC_RC_PROFILE_DP:  tables tuned for DP sinks
+ */
+enum sde_dsc_rc_profile {
+	SDE_DSC_RC_PROFILE_DSI,
+	SDE_DSC_RC_PROFILE_DP,
+	SDE_DSC_RC_PROFILE_MAX
+};
+
+/**
+ * sde_dsc_populate_dsc_config - derive the static rate control and
+ *	PPS parameters of a DSC configuration
+ * @dsc: dsc info with version, scr_rev, bpc, bpp and slice geometry set
+ * @profile: rate control table set to use
+ * @line_buf_depth_max: sink line buffer depth limit, 0 if unlimited
+ *
+ * Results are cached per (profile, version, bpc, bpp, slice geometry,
+ * line buffer depth), so repeated mode sets only copy the parameters.
+ * Return: 0 on success, negative error code on invalid input
+ */
+int sde_dsc_populate_dsc_config(struct msm_display_dsc_info *dsc,
+		enum sde_dsc_rc_profile profile, int line_buf_depth_max);
+
+/**
+ * sde_dsc_create_pps_buf_cmd - pack the picture parameter set
+ * @dsc: populated dsc info
+ * @buf: destination, at least SDE_DSC_PPS_SIZE bytes
+ * @pps_id: picture parameter set identifier
+ * Return: number of bytes written
+ */
+int sde_dsc_create_pps_buf_cmd(struct msm_display_dsc_info *dsc,
+		char *buf, int pps_id);
+
+#endif /* __SDE_DSC_HELPER_H__ */
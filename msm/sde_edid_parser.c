@@ -5,6 +5,7 @@
 
 #include <drm/drm_edid.h>
 #include <linux/hdmi.h>
+#include <linux/crc32.h>
 
 #include "sde_kms.h"
 #include "sde_edid_parser.h"
@@ -504,6 +505,171 @@ static void _sde_edid_extract_speaker_allocation_data(
 	SDE_EDID_DEBUG("%s -", __func__);
 }
 
+static u32 _sde_edid_size(struct edid *edid)
+{
+	return (edid->extensions + 1) * EDID_LENGTH;
+}
+
+static struct sde_edid_cache_entry *_sde_edid_cache_lookup(
+	struct sde_edid_ctrl *edid_ctrl, u8 *checksum, u32 *crc, u32 *size)
+{
+	struct sde_edid_cache_entry *entry;
+	int i;
+
+	*checksum = sde_get_edid_checksum(edid_ctrl);
+	*size = _sde_edid_size(edid_ctrl->edid);
+	*crc = crc32_le(~0, (u8 *)edid_ctrl->edid, *size);
+
+	for (i = 0; i < SDE_EDID_CACHE_MAX_ENTRIES; i++) {
+		entry = &edid_ctrl->cache.entries[i];
+
+		if (entry->valid && entry->checksum == *checksum &&
+				entry->crc == *crc && entry->size == *size) {
+			entry->last_used = jiffies;
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void _sde_edid_cache_release(struct sde_edid_cache_entry *entry)
+{
+	kfree(entry->modes);
+	memset(entry, 0, sizeof(*entry));
+}
+
+static struct sde_edid_cache_entry *_sde_edid_cache_alloc(
+	struct sde_edid_ctrl *edid_ctrl, u8 checksum, u32 crc, u32 size)
+{
+	struct sde_edid_cache_entry *entry, *victim = NULL;
+	int i;
+
+	for (i = 0; i < SDE_EDID_CACHE_MAX_ENTRIES; i++) {
+		entry = &edid_ctrl->cache.entries[i];
+
+		if (!entry->valid) {
+			victim = entry;
+			break;
+		}
+
+		if (!victim || time_before(entry->last_used, victim->last_used))
+			victim = entry;
+	}
+
+	_sde_edid_cache_release(victim);
+	victim->checksum = checksum;
+	victim->crc = crc;
+	victim->size = size;
+	victim->last_used = jiffies;
+
+	return victim;
+}
+
+static void _sde_edid_cache_store_parse(struct sde_edid_cache_entry *entry,
+	struct sde_edid_ctrl *edid_ctrl)
+{
+	memcpy(entry->audio_data_block, edid_ctrl->audio_data_block,
+		sizeof(entry->audio_data_block));
+	entry->adb_size = edid_ctrl->adb_size;
+	memcpy(entry->spkr_alloc_data_block, edid_ctrl->spkr_alloc_data_block,
+		sizeof(entry->spkr_alloc_data_block));
+	entry->sadb_size = edid_ctrl->sadb_size;
+	entry->audio_supported = edid_ctrl->audio_supported;
+	memcpy(entry->vendor_id, edid_ctrl->vendor_id,
+		sizeof(entry->vendor_id));
+	entry->valid = true;
+}
+
+static void _sde_edid_cache_load_parse(struct sde_edid_ctrl *edid_ctrl,
+	struct sde_edid_cache_entry *entry)
+{
+	memcpy(edid_ctrl->audio_data_block, entry->audio_data_block,
+		sizeof(edid_ctrl->audio_data_block));
+	edid_ctrl->adb_size = entry->adb_size;
+	memcpy(edid_ctrl->spkr_alloc_data_block, entry->spkr_alloc_data_block,
+		sizeof(edid_ctrl->spkr_alloc_data_block));
+	edid_ctrl->sadb_size = entry->sadb_size;
+	edid_ctrl->audio_supported = entry->audio_supported;
+	memcpy(edid_ctrl->vendor_id, entry->vendor_id,
+		sizeof(edid_ctrl->vendor_id));
+}
+
+static void _sde_edid_cache_store_modes(struct sde_edid_cache_entry *entry,
+	struct drm_connector *connector, int skip)
+{
+	struct drm_display_mode *mode;
+	int count = 0, i = 0;
+
+	list_for_each_entry(mode, &connector->probed_modes, head)
+		count++;
+
+	if (count <= skip)
+		return;
+
+	kfree(entry->modes);
+	entry->modes = kcalloc(count - skip, sizeof(*entry->modes),
+			GFP_KERNEL);
+	if (!entry->modes) {
+		entry->num_modes = 0;
+		return;
+	}
+
+	list_for_each_entry(mode, &connector->probed_modes, head) {
+		if (i++ < skip)
+			continue;
+
+		entry->modes[entry->num_modes] = *mode;
+		INIT_LIST_HEAD(&entry->modes[entry->num_modes].head);
+		entry->num_modes++;
+	}
+
+	entry->disp_info = connector->display_info;
+	memcpy(entry->eld, connector->eld, sizeof(entry->eld));
+	entry->modes_valid = true;
+}
+
+static int _sde_edid_cache_load_modes(struct sde_edid_cache_entry *entry,
+	struct drm_connector *connector)
+{
+	struct drm_display_info *info = &connector->display_info;
+	const u32 *bus_formats = info->bus_formats;
+	unsigned int num_bus_formats = info->num_bus_formats;
+	struct drm_display_mode *mode;
+	int i, added = 0;
+
+	/* bus formats are owned by the connector, not derived from EDID */
+	*info = entry->disp_info;
+	info->bus_formats = bus_formats;
+	info->num_bus_formats = num_bus_formats;
+	memcpy(connector->eld, entry->eld, sizeof(connector->eld));
+
+	for (i = 0; i < entry->num_modes; i++) {
+		mode = drm_mode_duplicate(connector->dev, &entry->modes[i]);
+		if (!mode) {
+			SDE_ERROR("failed to duplicate cached mode %d\n", i);
+			continue;
+		}
+
+		drm_mode_probed_add(connector, mode);
+		added++;
+	}
+
+	return added;
+}
+
+void sde_edid_cache_flush(void *input)
+{
+	struct sde_edid_ctrl *edid_ctrl = (struct sde_edid_ctrl *)(input);
+	int i;
+
+	if (!edid_ctrl)
+		return;
+
+	for (i = 0; i < SDE_EDID_CACHE_MAX_ENTRIES; i++)
+		_sde_edid_cache_release(&edid_ctrl->cache.entries[i]);
+}
+
 struct sde_edid_ctrl *sde_edid_init(void)
 {
 	struct sde_edid_ctrl *edid_ctrl = NULL;
@@ -534,6 +700,7 @@ void sde_edid_deinit(void **input)
 
 	SDE_EDID_DEBUG("%s +", __func__);
 	sde_free_edid((void *)&edid_ctrl);
+	sde_edid_cache_flush(edid_ctrl);
 	kfree(edid_ctrl);
 	SDE_EDID_DEBUG("%s -", __func__);
 }
@@ -541,17 +708,36 @@ void sde_edid_deinit(void **input)
 int _sde_edid_update_modes(struct drm_connector *connector,
 	void *input)
 {
-	int rc = 0;
+	int rc = 0, skip = 0;
 	struct sde_edid_ctrl *edid_ctrl = (struct sde_edid_ctrl *)(input);
+	struct sde_edid_cache_entry *entry;
+	struct drm_display_mode *mode;
+	u32 crc, size;
+	u8 checksum;
 
 	SDE_EDID_DEBUG("%s +", __func__);
 	if (edid_ctrl->edid) {
 		drm_connector_update_edid_property(connector,
 			edid_ctrl->edid);
 
+		entry = _sde_edid_cache_lookup(edid_ctrl, &checksum, &crc,
+				&size);
+		if (entry && entry->modes_valid) {
+			rc = _sde_edid_cache_load_modes(entry, connector);
+			SDE_EDID_DEBUG("%s cached modes:%d -", __func__, rc);
+			return rc;
+		}
+
+		list_for_each_entry(mode, &connector->probed_modes, head)
+			skip++;
+
 		rc = drm_add_edid_modes(connector, edid_ctrl->edid);
 		sde_edid_set_mode_format(connector, edid_ctrl);
 		_sde_edid_update_dc_modes(connector, edid_ctrl);
+
+		if (entry)
+			_sde_edid_cache_store_modes(entry, connector, skip);
+
 		SDE_EDID_DEBUG("%s -", __func__);
 		return rc;
 	}
@@ -592,9 +778,29 @@ bool sde_detect_hdmi_monitor(void *input)
 	return drm_detect_hdmi_monitor(edid_ctrl->edid);
 }
 
+bool sde_detect_monitor_audio(void *input)
+{
+	struct sde_edid_ctrl *edid_ctrl = (struct sde_edid_ctrl *)(input);
+	struct sde_edid_cache_entry *entry;
+	u32 crc, size;
+	u8 checksum;
+
+	if (!edid_ctrl || !edid_ctrl->edid)
+		return false;
+
+	entry = _sde_edid_cache_lookup(edid_ctrl, &checksum, &crc, &size);
+	if (entry)
+		return entry->audio_supported;
+
+	return drm_detect_monitor_audio(edid_ctrl->edid);
+}
+
 void sde_parse_edid(void *input)
 {
 	struct sde_edid_ctrl *edid_ctrl;
+	struct sde_edid_cache_entry *entry;
+	u32 crc, size;
+	u8 checksum;
 
 	if (!input) {
 		SDE_ERROR("Invalid input\n");
@@ -604,9 +810,27 @@ void sde_parse_edid(void *input)
 	edid_ctrl = (struct sde_edid_ctrl *)(input);
 
 	if (edid_ctrl->edid) {
+		entry = _sde_edid_cache_lookup(edid_ctrl, &checksum, &crc,
+				&size);
+		if (entry) {
+			_sde_edid_cache_load_parse(edid_ctrl, entry);
+			edid_ctrl->cache.hits++;
+			SDE_EDID_DEBUG("edid cache hit crc:0x%x hits:%u\n",
+				crc, edid_ctrl->cache.hits);
+			return;
+		}
+
 		sde_edid_extract_vendor_id(edid_ctrl);
 		_sde_edid_extract_audio_data_blocks(edid_ctrl);
 		_sde_edid_extract_speaker_allocation_data(edid_ctrl);
+		edid_ctrl->audio_supported =
+			drm_detect_monitor_audio(edid_ctrl->edid);
+
+		entry = _sde_edid_cache_alloc(edid_ctrl, checksum, crc, size);
+		_sde_edid_cache_store_parse(entry, edid_ctrl);
+		edid_ctrl->cache.misses++;
+		SDE_EDID_DEBUG("edid cache miss crc:0x%x misses:%u\n",
+			crc, edid_ctrl->cache.misses);
 	} else {
 		SDE_ERROR("edid not present\n");
 	}
@@ -20,6 +20,7 @@
 #define MAX_AUDIO_DATA_BLOCK_SIZE 30
 #define MAX_SPKR_ALLOC_DATA_BLOCK_SIZE 3
 #define EDID_VENDOR_ID_SIZE     4
+#define SDE_EDID_CACHE_MAX_ENTRIES 4
 
 #define SDE_CEA_EXT    0x02
 #define SDE_EXTENDED_TAG 0x07
@@ -70,6 +71,58 @@ struct sde_edid_sink_caps {
 	bool ind_view_support;
 };
 
+/*
+ * struct sde_edid_cache_entry - parse results of a previously seen EDID
+ * @valid: entry holds parse results
+ * @modes_valid: @modes/@disp_info/@eld were captured from a mode update
+ * @checksum: checksum byte of the last EDID block
+ * @crc: crc32 over the complete EDID content
+ * @size: size of the EDID in bytes
+ * @last_used: jiffies of the last lookup hit, used for LRU eviction
+ * @audio_data_block: cached audio data blocks
+ * @adb_size: size of the cached audio data blocks
+ * @spkr_alloc_data_block: cached speaker allocation data block
+ * @sadb_size: size of the cached speaker allocation data block
+ * @audio_supported: cached result of monitor audio detection
+ * @vendor_id: cached vendor id
+ * @modes: modes added to the connector by this EDID
+ * @num_modes: number of entries in @modes
+ * @disp_info: connector display info derived from this EDID
+ * @eld: connector ELD derived from this EDID
+ */
+struct sde_edid_cache_entry {
+	bool valid;
+	bool modes_valid;
+	u8 checksum;
+	u32 crc;
+	u32 size;
+	unsigned long last_used;
+
+	u8 audio_data_block[MAX_NUMBER_ADB * MAX_AUDIO_DATA_BLOCK_SIZE];
+	int adb_size;
+	u8 spkr_alloc_data_block[MAX_SPKR_ALLOC_DATA_BLOCK_SIZE];
+	int sadb_size;
+	bool audio_supported;
+	char vendor_id[EDID_VENDOR_ID_SIZE];
+
+	struct drm_display_mode *modes;
+	int num_modes;
+	struct drm_display_info disp_info;
+	u8 eld[MAX_ELD_BYTES];
+};
+
+/*
+ * struct sde_edid_cache - bounded per sink parse cache
+ * @entries: cache slots, evicted in LRU order
+ * @hits: number of parses served from the cache
+ * @misses: number of parses that had to walk the EDID
+ */
+struct sde_edid_cache {
+	struct sde_edid_cache_entry entries[SDE_EDID_CACHE_MAX_ENTRIES];
+	u32 hits;
+	u32 misses;
+};
+
 struct sde_edid_ctrl {
 	struct edid *edid;
 	u8 pt_scan_info;
@@ -83,6 +136,8 @@ struct sde_edid_ctrl {
 	char vendor_id[EDID_VENDOR_ID_SIZE];
 	struct sde_edid_sink_caps sink_caps;
 	struct sde_edid_hdr_data hdr_data;
+	bool audio_supported;
+	struct sde_edid_cache cache;
 };
 
 /**
@@ -144,6 +199,22 @@ bool sde_detect_hdmi_monitor(void *edid_ctrl);
  */
 u8 sde_get_edid_checksum(void *input);
 
+/**
+ * sde_detect_monitor_audio() - detect audio support of the sink.
+ * @edid_ctrl:     Handle to the edid_ctrl structure.
+ *
+ * Return: true if the sink advertises basic audio.
+ */
+bool sde_detect_monitor_audio(void *edid_ctrl);
+
+/**
+ * sde_edid_cache_flush() - drop all cached EDID parse results.
+ * @edid_ctrl:     Handle to the edid_ctrl structure.
+ *
+ * Return: void.
+ */
+void sde_edid_cache_flush(void *edid_ctrl);
+
 /**
  * _sde_edid_update_modes() - populate EDID modes.
  * @edid_ctrl:     Handle to the edid_ctrl structure.
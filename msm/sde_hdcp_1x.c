@@ -8,6 +8,7 @@
 #include <linux/io.h>
 #include <linux/types.h>
 #include <linux/delay.h>
+#include <linux/ktime.h>
 #include <linux/slab.h>
 #include <linux/stat.h>
 #include <linux/iopoll.h>
@@ -55,6 +56,9 @@
 #define HDCP_POLL_SLEEP_US   (20 * 1000)
 #define HDCP_POLL_TIMEOUT_US (HDCP_POLL_SLEEP_US * 100)
 
+/* SHA engine completes a block in a few usec, poll it more finely */
+#define HDCP_SHA_POLL_SLEEP_US 100
+
 #define sde_hdcp_1x_state(x) (hdcp->hdcp_state == x)
 
 struct sde_hdcp_sink_addr {
@@ -198,6 +202,31 @@ struct sde_hdcp_reg_set {
 	 BIT(16), BIT(19), BIT(21), BIT(23), BIT(26), 0, 0, \
 	 BIT(15), BIT(18), BIT(22), BIT(25), 0, 0}
 
+/**
+ * struct sde_hdcp_1x_auth_stats - authentication phase timings and counters
+ * @part1_us: time spent in the first part of authentication
+ * @ksv_ready_us: time spent waiting for the repeater KSV list to be ready
+ * @ksv_read_us: time spent reading bstatus and the KSV list
+ * @v_check_us: time spent in the SHA engine and V' comparison
+ * @total_us: duration of the last authentication attempt
+ * @auth_count: number of authentication attempts
+ * @fail_count: number of failed authentication attempts
+ * @ksv_reread_count: KSV list reads repeated due to an invalid KSV
+ *	or a V' mismatch
+ * @tp_cache_hits: KSV list reads matching the cached validated topology
+ */
+struct sde_hdcp_1x_auth_stats {
+	u32 part1_us;
+	u32 ksv_ready_us;
+	u32 ksv_read_us;
+	u32 v_check_us;
+	u32 total_us;
+	u32 auth_count;
+	u32 fail_count;
+	u32 ksv_reread_count;
+	u32 tp_cache_hits;
+};
+
 struct sde_hdcp_1x {
 	u8 bcaps;
 	u32 tp_msgid;
@@ -210,6 +239,9 @@ struct sde_hdcp_1x {
 	atomic_t abort;
 	enum sde_hdcp_state hdcp_state;
 	struct HDCP_V2V1_MSG_TOPOLOGY current_tp;
+	struct HDCP_V2V1_MSG_TOPOLOGY cached_tp;
+	bool cached_tp_valid;
+	struct sde_hdcp_1x_auth_stats stats;
 	struct delayed_work hdcp_auth_work;
 	struct completion r0_checked;
 	struct completion sink_r0_available;
@@ -810,6 +842,32 @@ end:
 	return rc;
 }
 
+static bool sde_hdcp_1x_ksv_list_valid(u8 *ksv_list, u32 dev_count)
+{
+	u32 i;
+
+	/* each KSV is 5 bytes long with 20 ones and 20 zeros */
+	for (i = 0; i < dev_count; i++)
+		if (sde_hdcp_1x_count_one(ksv_list + (5 * i), 5) != 20)
+			return false;
+
+	return true;
+}
+
+static bool sde_hdcp_1x_topology_cached(struct sde_hdcp_1x *hdcp)
+{
+	struct HDCP_V2V1_MSG_TOPOLOGY *tp = &hdcp->current_tp;
+	struct HDCP_V2V1_MSG_TOPOLOGY *cached = &hdcp->cached_tp;
+
+	if (!hdcp->cached_tp_valid)
+		return false;
+
+	return cached->dev_count == tp->dev_count &&
+		cached->depth == tp->depth &&
+		!memcmp(cached->bksv, tp->bksv, sizeof(tp->bksv)) &&
+		!memcmp(cached->ksv_list, tp->ksv_list, 5 * tp->dev_count);
+}
+
 static int sde_hdcp_1x_read_ksv_fifo(struct sde_hdcp_1x *hdcp)
 {
 	u32 ksv_read_retry = 20, ksv_bytes, rc = 0;
@@ -829,11 +887,25 @@ static int sde_hdcp_1x_read_ksv_fifo(struct sde_hdcp_1x *hdcp)
 	while (ksv_bytes && --ksv_read_retry) {
 		rc = sde_hdcp_1x_read(hdcp, &hdcp->sink_addr.ksv_fifo,
 				ksv_fifo, true);
-		if (rc)
+		if (rc) {
 			pr_err("could not read ksv fifo (%d)\n",
 				ksv_read_retry);
-		else
+			continue;
+		}
+
+		if (sde_hdcp_1x_topology_cached(hdcp)) {
+			hdcp->stats.tp_cache_hits++;
 			break;
+		}
+
+		if (sde_hdcp_1x_ksv_list_valid(ksv_fifo,
+				hdcp->current_tp.dev_count))
+			break;
+
+		/* a corrupted read would only fail later as a V mismatch */
+		pr_err("invalid ksv in fifo (%d)\n", ksv_read_retry);
+		hdcp->stats.ksv_reread_count++;
+		rc = -EINVAL;
 	}
 
 	if (rc)
@@ -873,7 +945,7 @@ static int sde_hdcp_1x_write_ksv_fifo(struct sde_hdcp_1x *hdcp)
 			rc = readl_poll_timeout(io->base + reg_set->sha_status,
 				sha_status, (sha_status & BIT(0)) ||
 				!sde_hdcp_1x_state(HDCP_STATE_AUTHENTICATING),
-				HDCP_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
+				HDCP_SHA_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
 			if (rc) {
 				pr_err("block not done\n");
 				goto error;
@@ -889,7 +961,7 @@ static int sde_hdcp_1x_write_ksv_fifo(struct sde_hdcp_1x *hdcp)
 	rc = readl_poll_timeout(io->base + reg_set->sha_status, sha_status,
 				(sha_status & BIT(4)) ||
 				!sde_hdcp_1x_state(HDCP_STATE_AUTHENTICATING),
-				HDCP_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
+				HDCP_SHA_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
 	if (rc) {
 		pr_err("V computation not done\n");
 		goto error;
@@ -899,7 +971,7 @@ static int sde_hdcp_1x_write_ksv_fifo(struct sde_hdcp_1x *hdcp)
 	rc = readl_poll_timeout(io->base + reg_set->status, status,
 				(status & BIT(reg_set->v_offset)) ||
 				!sde_hdcp_1x_state(HDCP_STATE_AUTHENTICATING),
-				HDCP_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
+				HDCP_SHA_POLL_SLEEP_US, HDCP_POLL_TIMEOUT_US);
 	if (rc) {
 		pr_err("V mismatch\n");
 		rc = -EINVAL;
@@ -990,6 +1062,7 @@ static int sde_hdcp_1x_authentication_part2(struct sde_hdcp_1x *hdcp)
 {
 	int rc;
 	int v_retry = 3;
+	ktime_t ts = ktime_get();
 
 	rc = sde_hdcp_1x_validate_downstream(hdcp);
 	if (rc)
@@ -999,6 +1072,9 @@ static int sde_hdcp_1x_authentication_part2(struct sde_hdcp_1x *hdcp)
 	if (rc)
 		goto error;
 
+	hdcp->stats.ksv_read_us = ktime_us_delta(ktime_get(), ts);
+	ts = ktime_get();
+
 	do {
 		rc = sde_hdcp_1x_transfer_v_h(hdcp);
 		if (rc)
@@ -1009,12 +1085,26 @@ static int sde_hdcp_1x_authentication_part2(struct sde_hdcp_1x *hdcp)
 			goto error;
 
 		rc = sde_hdcp_1x_write_ksv_fifo(hdcp);
+		if (!rc || v_retry == 1 ||
+		    !sde_hdcp_1x_state(HDCP_STATE_AUTHENTICATING))
+			continue;
+
+		/* V' covers the KSV list, re-read it before retrying */
+		hdcp->stats.ksv_reread_count++;
+		rc = sde_hdcp_1x_read_ksv_fifo(hdcp);
+		if (rc)
+			goto error;
+		rc = -EINVAL;
 	} while (--v_retry && rc);
+
+	hdcp->stats.v_check_us = ktime_us_delta(ktime_get(), ts);
 error:
 	if (rc) {
 		pr_err("%s: FAILED\n", SDE_HDCP_STATE_NAME);
 	} else {
 		hdcp->hdcp_state = HDCP_STATE_AUTHENTICATED;
+		hdcp->cached_tp = hdcp->current_tp;
+		hdcp->cached_tp_valid = true;
 
 		pr_info("SUCCESSFUL\n");
 	}
@@ -1046,6 +1136,7 @@ static void sde_hdcp_1x_auth_work(struct work_struct *work)
 	struct sde_hdcp_1x *hdcp = container_of(dw,
 		struct sde_hdcp_1x, hdcp_auth_work);
 	struct dss_io_data *io;
+	ktime_t start = ktime_get(), ts;
 
 	if (!hdcp) {
 		pr_err("invalid input\n");
@@ -1066,6 +1157,11 @@ static void sde_hdcp_1x_auth_work(struct work_struct *work)
 	hdcp->reauth = false;
 	hdcp->ksv_ready = false;
 
+	hdcp->stats.auth_count++;
+	hdcp->stats.ksv_ready_us = 0;
+	hdcp->stats.ksv_read_us = 0;
+	hdcp->stats.v_check_us = 0;
+
 	io = hdcp->init_data.core_io;
 	/* Enabling Software DDC for HDMI and REF timer for DP */
 	if (hdcp->init_data.client_id == HDCP_CLIENT_DP) {
@@ -1083,11 +1179,14 @@ static void sde_hdcp_1x_auth_work(struct work_struct *work)
 		hdcp1_set_enc(hdcp->hdcp1_handle, true);
 
 	rc = sde_hdcp_1x_authentication_part1(hdcp);
+	hdcp->stats.part1_us = ktime_us_delta(ktime_get(), start);
 	if (rc)
 		goto end;
 
 	if (hdcp->current_tp.ds_type == DS_REPEATER) {
+		ts = ktime_get();
 		rc = sde_hdcp_1x_wait_for_ksv_ready(hdcp);
+		hdcp->stats.ksv_ready_us = ktime_us_delta(ktime_get(), ts);
 		if (rc)
 			goto end;
 	} else {
@@ -1109,6 +1208,18 @@ end:
 	if (rc && !sde_hdcp_1x_state(HDCP_STATE_INACTIVE))
 		hdcp->hdcp_state = HDCP_STATE_AUTH_FAIL;
 
+	if (rc)
+		hdcp->stats.fail_count++;
+
+	hdcp->stats.total_us = ktime_us_delta(ktime_get(), start);
+	pr_debug("%s: part1 %uus ksv_ready %uus ksv_read %uus v %uus total %uus\n",
+		SDE_HDCP_STATE_NAME, hdcp->stats.part1_us,
+		hdcp->stats.ksv_ready_us, hdcp->stats.ksv_read_us,
+		hdcp->stats.v_check_us, hdcp->stats.total_us);
+	pr_debug("auth %u fail %u ksv_reread %u tp_cache_hits %u\n",
+		hdcp->stats.auth_count, hdcp->stats.fail_count,
+		hdcp->stats.ksv_reread_count, hdcp->stats.tp_cache_hits);
+
 	sde_hdcp_1x_update_auth_status(hdcp);
 }
 
@@ -279,8 +279,16 @@ enum sde_rsc_state get_sde_rsc_current_state(int rsc_index)
 }
 EXPORT_SYMBOL(get_sde_rsc_current_state);
 
-static u32 sde_rsc_timer_calculate(struct sde_rsc_priv *rsc,
-	struct sde_rsc_cmd_config *cmd_config, enum sde_rsc_state state)
+/**
+ * _sde_rsc_timer_compute - derive the timer configuration for a panel config
+ * @rsc: rsc private handle, only its static timing parameters are read
+ * @config: resolved panel config, all fields non-zero
+ * @cmd_state: true to account for frame jitter (cmd state)
+ * @timer: timer configuration to fill
+ */
+static void _sde_rsc_timer_compute(const struct sde_rsc_priv *rsc,
+	const struct sde_rsc_cmd_config *config, bool cmd_state,
+	struct sde_rsc_timer_config *timer)
 {
 	const u32 cxo_period_ns = 52;
 	u64 rsc_backoff_time_ns = rsc->backoff_time_ns;
@@ -293,47 +301,22 @@ static u32 sde_rsc_timer_calculate(struct sde_rsc_priv *rsc,
 	u64 line_time_ns, prefill_time_ns;
 	u64 pdc_backoff_time_ns;
 	s64 total;
-	int ret = 0;
-	u32 default_prefill_lines;
-
-	if (cmd_config)
-		memcpy(&rsc->cmd_config, cmd_config, sizeof(*cmd_config));
-
-	/* calculate for 640x480 60 fps resolution by default */
-	if (!rsc->cmd_config.fps)
-		rsc->cmd_config.fps = DEFAULT_PANEL_FPS;
-	if (!rsc->cmd_config.jitter_numer)
-		rsc->cmd_config.jitter_numer = DEFAULT_PANEL_JITTER_NUMERATOR;
-	if (!rsc->cmd_config.jitter_denom)
-		rsc->cmd_config.jitter_denom = DEFAULT_PANEL_JITTER_DENOMINATOR;
-	if (!rsc->cmd_config.vtotal)
-		rsc->cmd_config.vtotal = DEFAULT_PANEL_VTOTAL;
-
-	default_prefill_lines = (rsc->cmd_config.fps *
-		DEFAULT_PANEL_MIN_V_PREFILL) / DEFAULT_PANEL_FPS;
-	if ((state == SDE_RSC_CMD_STATE) || !rsc->cmd_config.prefill_lines)
-		rsc->cmd_config.prefill_lines = default_prefill_lines;
-
-	pr_debug("frame fps:%d jitter_numer:%d jitter_denom:%d vtotal:%d prefill lines:%d\n",
-		rsc->cmd_config.fps, rsc->cmd_config.jitter_numer,
-		rsc->cmd_config.jitter_denom, rsc->cmd_config.vtotal,
-		rsc->cmd_config.prefill_lines);
 
 	/* 1 nano second */
 	frame_time_ns = TICKS_IN_NANO_SECOND;
-	frame_time_ns = div_u64(frame_time_ns, rsc->cmd_config.fps);
+	frame_time_ns = div_u64(frame_time_ns, config->fps);
 
-	frame_jitter = frame_time_ns * rsc->cmd_config.jitter_numer;
-	frame_jitter = div_u64(frame_jitter, rsc->cmd_config.jitter_denom);
+	frame_jitter = frame_time_ns * config->jitter_numer;
+	frame_jitter = div_u64(frame_jitter, config->jitter_denom);
 	/* convert it to percentage */
 	frame_jitter = div_u64(frame_jitter, 100);
 
 	line_time_ns = frame_time_ns;
-	line_time_ns = div_u64(line_time_ns, rsc->cmd_config.vtotal);
-	prefill_time_ns = line_time_ns * rsc->cmd_config.prefill_lines;
+	line_time_ns = div_u64(line_time_ns, config->vtotal);
+	prefill_time_ns = line_time_ns * config->prefill_lines;
 
 	/* only take jitter into account for CMD mode */
-	if (state == SDE_RSC_CMD_STATE)
+	if (cmd_state)
 		total = frame_time_ns - frame_jitter - prefill_time_ns;
 	else
 		total = frame_time_ns - prefill_time_ns;
@@ -345,7 +328,7 @@ static u32 sde_rsc_timer_calculate(struct sde_rsc_priv *rsc,
 	}
 
 	total = div_u64(total, cxo_period_ns);
-	rsc->timer_config.static_wakeup_time_ns = total;
+	timer->static_wakeup_time_ns = total;
 
 	pr_debug("frame time:%llu frame jiter_time:%llu\n",
 			frame_time_ns, frame_jitter);
@@ -355,32 +338,120 @@ static u32 sde_rsc_timer_calculate(struct sde_rsc_priv *rsc,
 
 	pdc_backoff_time_ns = rsc_backoff_time_ns;
 	rsc_backoff_time_ns = div_u64(rsc_backoff_time_ns, cxo_period_ns);
-	rsc->timer_config.rsc_backoff_time_ns = (u32) rsc_backoff_time_ns;
+	timer->rsc_backoff_time_ns = (u32) rsc_backoff_time_ns;
 
 	pdc_backoff_time_ns *= pdc_jitter;
 	pdc_backoff_time_ns = div_u64(pdc_backoff_time_ns, 100);
-	rsc->timer_config.pdc_backoff_time_ns = (u32) pdc_backoff_time_ns;
+	timer->pdc_backoff_time_ns = (u32) pdc_backoff_time_ns;
 
 	rsc_mode_threshold_time_ns =
 			div_u64(rsc_mode_threshold_time_ns, cxo_period_ns);
-	rsc->timer_config.rsc_mode_threshold_time_ns
-					= (u32) rsc_mode_threshold_time_ns;
+	timer->rsc_mode_threshold_time_ns = (u32) rsc_mode_threshold_time_ns;
 
 	/* time_slot_0 for mode0 latency */
 	rsc_time_slot_0_ns = div_u64(rsc_time_slot_0_ns, cxo_period_ns);
-	rsc->timer_config.rsc_time_slot_0_ns = (u32) rsc_time_slot_0_ns;
+	timer->rsc_time_slot_0_ns = (u32) rsc_time_slot_0_ns;
 
 	/* time_slot_1 for mode1 latency */
 	rsc_time_slot_1_ns = frame_time_ns;
 	rsc_time_slot_1_ns = div_u64(rsc_time_slot_1_ns, cxo_period_ns);
-	rsc->timer_config.rsc_time_slot_1_ns = (u32) rsc_time_slot_1_ns;
+	timer->rsc_time_slot_1_ns = (u32) rsc_time_slot_1_ns;
 
 	/* mode 2 is infinite */
-	rsc->timer_config.rsc_time_slot_2_ns = 0xFFFFFFFF;
+	timer->rsc_time_slot_2_ns = 0xFFFFFFFF;
+
+	timer->min_threshold_time_ns = MIN_THRESHOLD_OVERHEAD_TIME;
+	timer->bwi_threshold_time_ns = timer->rsc_time_slot_0_ns;
+}
+
+/**
+ * _sde_rsc_timer_lookup - get the timer configuration for a panel config
+ *	The result is taken from the per-rsc cache when the same panel
+ *	config was seen before; otherwise it is computed and replaces the
+ *	least recently used entry.
+ * @rsc: rsc private handle
+ * @config: resolved panel config
+ * @cmd_state: true if the timers are for cmd state
+ * Return: cached timer configuration
+ */
+static const struct sde_rsc_timer_config *_sde_rsc_timer_lookup(
+	struct sde_rsc_priv *rsc, const struct sde_rsc_cmd_config *config,
+	bool cmd_state)
+{
+	struct sde_rsc_timer_cache_entry *entry, *victim = NULL;
+	int i;
+
+	if (!++rsc->timer_cache_gen) {
+		/* generation wrapped, restart ageing from scratch */
+		for (i = 0; i < SDE_RSC_TIMER_CACHE_SIZE; i++)
+			rsc->timer_cache[i].last_use =
+				!!rsc->timer_cache[i].last_use;
+		rsc->timer_cache_gen = 2;
+	}
+
+	for (i = 0; i < SDE_RSC_TIMER_CACHE_SIZE; i++) {
+		entry = &rsc->timer_cache[i];
+
+		if (entry->last_use && entry->cmd_state == cmd_state &&
+		    entry->fps == config->fps &&
+		    entry->vtotal == config->vtotal &&
+		    entry->jitter_numer == config->jitter_numer &&
+		    entry->jitter_denom == config->jitter_denom &&
+		    entry->prefill_lines == config->prefill_lines) {
+			entry->last_use = rsc->timer_cache_gen;
+			rsc->timer_cache_hits++;
+			return &entry->timer_config;
+		}
+
+		if (!victim || entry->last_use < victim->last_use)
+			victim = entry;
+	}
+
+	victim->cmd_state = cmd_state;
+	victim->fps = config->fps;
+	victim->vtotal = config->vtotal;
+	victim->jitter_numer = config->jitter_numer;
+	victim->jitter_denom = config->jitter_denom;
+	victim->prefill_lines = config->prefill_lines;
+	victim->last_use = rsc->timer_cache_gen;
+	_sde_rsc_timer_compute(rsc, config, cmd_state, &victim->timer_config);
+	rsc->timer_cache_misses++;
+
+	return &victim->timer_config;
+}
+
+static u32 sde_rsc_timer_calculate(struct sde_rsc_priv *rsc,
+	struct sde_rsc_cmd_config *cmd_config, enum sde_rsc_state state)
+{
+	int ret = 0;
+	u32 default_prefill_lines;
+
+	if (cmd_config)
+		memcpy(&rsc->cmd_config, cmd_config, sizeof(*cmd_config));
+
+	/* calculate for 640x480 60 fps resolution by default */
+	if (!rsc->cmd_config.fps)
+		rsc->cmd_config.fps = DEFAULT_PANEL_FPS;
+	if (!rsc->cmd_config.jitter_numer)
+		rsc->cmd_config.jitter_numer = DEFAULT_PANEL_JITTER_NUMERATOR;
+	if (!rsc->cmd_config.jitter_denom)
+		rsc->cmd_config.jitter_denom = DEFAULT_PANEL_JITTER_DENOMINATOR;
+	if (!rsc->cmd_config.vtotal)
+		rsc->cmd_config.vtotal = DEFAULT_PANEL_VTOTAL;
+
+	default_prefill_lines = (rsc->cmd_config.fps *
+		DEFAULT_PANEL_MIN_V_PREFILL) / DEFAULT_PANEL_FPS;
+	if ((state == SDE_RSC_CMD_STATE) || !rsc->cmd_config.prefill_lines)
+		rsc->cmd_config.prefill_lines = default_prefill_lines;
+
+	pr_debug("frame fps:%d jitter_numer:%d jitter_denom:%d vtotal:%d prefill lines:%d\n",
+		rsc->cmd_config.fps, rsc->cmd_config.jitter_numer,
+		rsc->cmd_config.jitter_denom, rsc->cmd_config.vtotal,
+		rsc->cmd_config.prefill_lines);
 
-	rsc->timer_config.min_threshold_time_ns = MIN_THRESHOLD_OVERHEAD_TIME;
-	rsc->timer_config.bwi_threshold_time_ns =
-		rsc->timer_config.rsc_time_slot_0_ns;
+	memcpy(&rsc->timer_config, _sde_rsc_timer_lookup(rsc,
+			&rsc->cmd_config, state == SDE_RSC_CMD_STATE),
+			sizeof(rsc->timer_config));
 
 	/* timer update should be called with client call */
 	if (cmd_config && rsc->hw_ops.timer_update) {
@@ -1379,6 +1450,10 @@ static void _sde_rsc_init_debugfs(struct sde_rsc_priv *rsc, char *name)
 							&vsync_status_fops);
 	debugfs_create_x32("debug_mode", 0600, rsc->debugfs_root,
 							&rsc->debug_mode);
+	debugfs_create_u32("timer_cache_hits", 0400, rsc->debugfs_root,
+							&rsc->timer_cache_hits);
+	debugfs_create_u32("timer_cache_misses", 0400, rsc->debugfs_root,
+							&rsc->timer_cache_misses);
 }
 #else
 static void _sde_rsc_init_debugfs(struct sde_rsc_priv *rsc, char *name)
@@ -24,6 +24,8 @@
 
 #define MAX_COUNT_SIZE_SUPPORTED	128
 
+#define SDE_RSC_TIMER_CACHE_SIZE	8
+
 #define SDE_RSC_REV_1			0x1
 #define SDE_RSC_REV_2			0x2
 #define SDE_RSC_REV_3			0x3
@@ -127,6 +129,29 @@ struct sde_rsc_timer_config {
 	u32 bwi_threshold_time_ns;
 };
 
+/**
+ * struct sde_rsc_timer_cache_entry: timer configuration computed for a mode
+ *
+ * @cmd_state:		true if computed for cmd state, with frame jitter
+ * @fps:		resolved panel fps
+ * @vtotal:		resolved panel vtotal
+ * @jitter_numer:	resolved panel jitter numerator
+ * @jitter_denom:	resolved panel jitter denominator
+ * @prefill_lines:	resolved panel prefill lines
+ * @last_use:		lookup generation of the last hit, 0 if the entry is empty
+ * @timer_config:	timer configuration for the panel config above
+ */
+struct sde_rsc_timer_cache_entry {
+	bool cmd_state;
+	u32 fps;
+	u32 vtotal;
+	u32 jitter_numer;
+	u32 jitter_denom;
+	u32 prefill_lines;
+	u32 last_use;
+	struct sde_rsc_timer_config timer_config;
+};
+
 /**
  * struct sde_rsc_bw_config: bandwidth configuration
  *
@@ -159,6 +184,10 @@ struct sde_rsc_bw_config {
  * @client_lock:	current rsc client synchronization lock
  *
  * timer_config:	current rsc timer configuration
+ * timer_cache:		timer configurations of recently used panel configs
+ * timer_cache_gen:	lookup generation used to age timer_cache entries
+ * timer_cache_hits:	timer configurations served from timer_cache
+ * timer_cache_misses:	timer configurations computed on a cache miss
  * cmd_config:		current panel config
  * current_state:	current rsc state (video/command), solver
  *                      override/enabled.
@@ -204,6 +233,10 @@ struct sde_rsc_priv {
 	struct mutex client_lock;
 
 	struct sde_rsc_timer_config timer_config;
+	struct sde_rsc_timer_cache_entry timer_cache[SDE_RSC_TIMER_CACHE_SIZE];
+	u32 timer_cache_gen;
+	u32 timer_cache_hits;
+	u32 timer_cache_misses;
 	struct sde_rsc_cmd_config cmd_config;
 	u32	current_state;
 	u32	vsync_source;
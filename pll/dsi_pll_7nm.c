@@ -256,6 +256,8 @@ struct dsi_pll_regs {
 	u32 ssc_adjper_low;
 	u32 ssc_adjper_high;
 	u32 ssc_control;
+	u32 analog_controls_five_1;
+	u32 vco_config_1;
 };
 
 struct dsi_pll_config {
@@ -276,11 +278,47 @@ struct dsi_pll_config {
 	u32 refclk_cycles;
 };
 
+/*
+ * One entry per dynamic refresh rate, plus a couple of slots for rates
+ * that are only reached through a full vco set_rate.
+ */
+#define DSI_PLL_SOLUTION_CACHE_SIZE	(DFPS_MAX_NUM_OF_FRAME_RATES + 2)
+
+/**
+ * struct dsi_pll_solution - divider and ssc settings of one vco rate
+ * @vco_rate: vco rate the settings were computed for
+ * @ref_rate: vco reference clock rate
+ * @pll_interface_type: pll hw revision
+ * @enable_ssc: spread spectrum enabled
+ * @ssc_center: center spread
+ * @ssc_freq: spread spectrum modulation frequency
+ * @ssc_offset: spread spectrum offset in ppm
+ * @regs: computed register values
+ * @stamp: last use, for replacement
+ * @valid: entry holds a solution
+ */
+struct dsi_pll_solution {
+	u64 vco_rate;
+	u64 ref_rate;
+	u32 pll_interface_type;
+	bool enable_ssc;
+	bool ssc_center;
+	u32 ssc_freq;
+	u32 ssc_offset;
+	struct dsi_pll_regs regs;
+	u32 stamp;
+	bool valid;
+};
+
 struct dsi_pll_7nm {
 	struct mdss_pll_resources *rsc;
 	struct dsi_pll_config pll_configuration;
 	struct dsi_pll_regs reg_setup;
 	bool cphy_enabled;
+	struct dsi_pll_solution solutions[DSI_PLL_SOLUTION_CACHE_SIZE];
+	u32 solution_stamp;
+	u32 solution_hits;
+	u32 solution_misses;
 };
 
 static inline bool dsi_pll_7nm_is_hw_revision_v1(
@@ -566,8 +604,8 @@ static void dsi_pll_config_slave(struct mdss_pll_resources *rsc)
 	pr_debug("Slave PLL %s\n", rsc->slave ? "configured" : "absent");
 }
 
-static void dsi_pll_setup_config(struct dsi_pll_7nm *pll,
-				 struct mdss_pll_resources *rsc)
+static void dsi_pll_init_config(struct dsi_pll_7nm *pll,
+				struct mdss_pll_resources *rsc)
 {
 	struct dsi_pll_config *config = &pll->pll_configuration;
 
@@ -594,24 +632,27 @@ static void dsi_pll_setup_config(struct dsi_pll_7nm *pll,
 		if (rsc->ssc_ppm)
 			config->ssc_offset = rsc->ssc_ppm;
 	}
+}
+
+static void dsi_pll_setup_config(struct dsi_pll_7nm *pll,
+				 struct mdss_pll_resources *rsc)
+{
+	dsi_pll_init_config(pll, rsc);
 
 	dsi_pll_config_slave(rsc);
 }
 
 static void dsi_pll_calc_dec_frac(struct dsi_pll_7nm *pll,
-				  struct mdss_pll_resources *rsc)
+				  struct mdss_pll_resources *rsc,
+				  u64 pll_freq, u64 fref,
+				  struct dsi_pll_regs *regs)
 {
 	struct dsi_pll_config *config = &pll->pll_configuration;
-	struct dsi_pll_regs *regs = &pll->reg_setup;
-	u64 fref = rsc->vco_ref_clk_rate;
-	u64 pll_freq;
 	u64 divider;
 	u64 dec, dec_multiple;
 	u32 frac;
 	u64 multiplier;
 
-	pll_freq = rsc->vco_current_rate;
-
 	if (config->disable_prescaler)
 		divider = fref;
 	else
@@ -626,9 +667,13 @@ static void dsi_pll_calc_dec_frac(struct dsi_pll_7nm *pll,
 	switch (rsc->pll_interface_type) {
 	case MDSS_DSI_PLL_7NM:
 		regs->pll_clock_inverters = 0x0;
+		regs->analog_controls_five_1 = 0x01;
+		regs->vco_config_1 = 0x00;
 		break;
 	case MDSS_DSI_PLL_7NM_V2:
 		regs->pll_clock_inverters = 0x28;
+		regs->analog_controls_five_1 = 0x01;
+		regs->vco_config_1 = 0x00;
 		break;
 	case MDSS_DSI_PLL_7NM_V4_1:
 	default:
@@ -640,6 +685,18 @@ static void dsi_pll_calc_dec_frac(struct dsi_pll_7nm *pll,
 			regs->pll_clock_inverters = 0x00;
 		else
 			regs->pll_clock_inverters = 0x40;
+
+		if (pll_freq < 3100000000ULL)
+			regs->analog_controls_five_1 = 0x01;
+		else
+			regs->analog_controls_five_1 = 0x03;
+
+		if (pll_freq < 1520000000ULL)
+			regs->vco_config_1 = 0x08;
+		else if (pll_freq < 2990000000ULL)
+			regs->vco_config_1 = 0x01;
+		else
+			regs->vco_config_1 = 0x00;
 		break;
 	}
 
@@ -652,10 +709,9 @@ static void dsi_pll_calc_dec_frac(struct dsi_pll_7nm *pll,
 }
 
 static void dsi_pll_calc_ssc(struct dsi_pll_7nm *pll,
-		  struct mdss_pll_resources *rsc)
+		  struct mdss_pll_resources *rsc, struct dsi_pll_regs *regs)
 {
 	struct dsi_pll_config *config = &pll->pll_configuration;
-	struct dsi_pll_regs *regs = &pll->reg_setup;
 	u32 ssc_per;
 	u32 ssc_mod;
 	u64 ssc_step_size;
@@ -696,6 +752,110 @@ static void dsi_pll_calc_ssc(struct dsi_pll_7nm *pll,
 			ssc_per, (u32)ssc_step_size, config->ssc_adj_per);
 }
 
+static bool dsi_pll_solution_match(const struct dsi_pll_solution *sol,
+				   const struct dsi_pll_config *config,
+				   struct mdss_pll_resources *rsc,
+				   u64 vco_rate, u64 ref_rate)
+{
+	if (!sol->valid || sol->vco_rate != vco_rate ||
+	    sol->ref_rate != ref_rate ||
+	    sol->pll_interface_type != rsc->pll_interface_type ||
+	    sol->enable_ssc != config->enable_ssc)
+		return false;
+
+	/* ssc parameters only matter when spread spectrum is on */
+	return !config->enable_ssc ||
+		(sol->ssc_center == config->ssc_center &&
+		 sol->ssc_freq == config->ssc_freq &&
+		 sol->ssc_offset == config->ssc_offset);
+}
+
+/*
+ * dsi_pll_solve() returns the divider and ssc settings of a vco rate for the
+ * current pll configuration. The settings only depend on the rate, the
+ * reference clock, the ssc parameters and the hw revision, so they are cached
+ * per pll. This keeps the 64-bit divisions off the dynamic refresh path,
+ * which switches between a small set of bit clock rates.
+ */
+static const struct dsi_pll_regs *dsi_pll_solve(struct dsi_pll_7nm *pll,
+		struct mdss_pll_resources *rsc, u64 vco_rate, u64 ref_rate)
+{
+	const struct dsi_pll_config *config = &pll->pll_configuration;
+	struct dsi_pll_solution *sol, *victim = &pll->solutions[0];
+	int i;
+
+	for (i = 0; i < DSI_PLL_SOLUTION_CACHE_SIZE; i++) {
+		sol = &pll->solutions[i];
+		if (dsi_pll_solution_match(sol, config, rsc, vco_rate,
+					   ref_rate)) {
+			sol->stamp = ++pll->solution_stamp;
+			pll->solution_hits++;
+			return &sol->regs;
+		}
+
+		if (!sol->valid)
+			victim = sol;
+		else if (victim->valid && sol->stamp < victim->stamp)
+			victim = sol;
+	}
+
+	pll->solution_misses++;
+	pr_debug("ndx=%d, vco=%llu solved, hits=%u misses=%u\n", rsc->index,
+			vco_rate, pll->solution_hits, pll->solution_misses);
+
+	sol = victim;
+	memset(&sol->regs, 0, sizeof(sol->regs));
+	dsi_pll_calc_dec_frac(pll, rsc, vco_rate, ref_rate, &sol->regs);
+	dsi_pll_calc_ssc(pll, rsc, &sol->regs);
+
+	sol->vco_rate = vco_rate;
+	sol->ref_rate = ref_rate;
+	sol->pll_interface_type = rsc->pll_interface_type;
+	sol->enable_ssc = config->enable_ssc;
+	sol->ssc_center = config->ssc_center;
+	sol->ssc_freq = config->ssc_freq;
+	sol->ssc_offset = config->ssc_offset;
+	sol->stamp = ++pll->solution_stamp;
+	sol->valid = true;
+
+	return &sol->regs;
+}
+
+static void dsi_pll_calc_regs(struct dsi_pll_7nm *pll,
+			      struct mdss_pll_resources *rsc)
+{
+	pll->reg_setup = *dsi_pll_solve(pll, rsc, rsc->vco_current_rate,
+					rsc->vco_ref_clk_rate);
+}
+
+/*
+ * Solve every rate of the dynamic refresh table at probe, so that bit clock
+ * switches never have to compute dividers. Register values that depend on
+ * the live PHY state are still read back when the shadow set is programmed.
+ */
+static void dsi_pll_presolve_dfps_rates(struct dsi_pll_7nm *pll,
+					struct mdss_pll_resources *rsc,
+					u64 ref_rate)
+{
+	int i;
+
+	if (!rsc->dfps)
+		return;
+
+	dsi_pll_init_config(pll, rsc);
+
+	for (i = 0; i < rsc->dfps->vco_rate_cnt &&
+			i < DFPS_MAX_NUM_OF_FRAME_RATES; i++) {
+		const struct dfps_codes_info *codes_info =
+			&rsc->dfps->codes_dfps[i];
+
+		if (!codes_info->is_valid || !codes_info->clk_rate)
+			continue;
+
+		dsi_pll_solve(pll, rsc, codes_info->clk_rate, ref_rate);
+	}
+}
+
 static void dsi_pll_ssc_commit(struct dsi_pll_7nm *pll,
 		struct mdss_pll_resources *rsc)
 {
@@ -726,32 +886,11 @@ static void dsi_pll_config_hzindep_reg(struct dsi_pll_7nm *pll,
 				  struct mdss_pll_resources *rsc)
 {
 	void __iomem *pll_base = rsc->pll_base;
-	u64 vco_rate = rsc->vco_current_rate;
-
-	switch (rsc->pll_interface_type) {
-	case MDSS_DSI_PLL_7NM:
-	case MDSS_DSI_PLL_7NM_V2:
-		MDSS_PLL_REG_W(pll_base, PLL_ANALOG_CONTROLS_FIVE_1, 0x01);
-		MDSS_PLL_REG_W(pll_base, PLL_VCO_CONFIG_1, 0x00);
-		break;
-	case MDSS_DSI_PLL_7NM_V4_1:
-	default:
-		if (vco_rate < 3100000000ULL)
-			MDSS_PLL_REG_W(pll_base,
-					PLL_ANALOG_CONTROLS_FIVE_1, 0x01);
-		else
-			MDSS_PLL_REG_W(pll_base,
-					PLL_ANALOG_CONTROLS_FIVE_1, 0x03);
-
-		if (vco_rate < 1520000000ULL)
-			MDSS_PLL_REG_W(pll_base, PLL_VCO_CONFIG_1, 0x08);
-		else if (vco_rate < 2990000000ULL)
-			MDSS_PLL_REG_W(pll_base, PLL_VCO_CONFIG_1, 0x01);
-		else
-			MDSS_PLL_REG_W(pll_base, PLL_VCO_CONFIG_1, 0x00);
+	struct dsi_pll_regs *regs = &pll->reg_setup;
 
-		break;
-	}
+	MDSS_PLL_REG_W(pll_base, PLL_ANALOG_CONTROLS_FIVE_1,
+			regs->analog_controls_five_1);
+	MDSS_PLL_REG_W(pll_base, PLL_VCO_CONFIG_1, regs->vco_config_1);
 
 	if (dsi_pll_7nm_is_hw_revision_v1(rsc))
 		MDSS_PLL_REG_W(pll_base, PLL_GEAR_BAND_SELECT_CONTROLS, 0x21);
@@ -1012,9 +1151,7 @@ static int vco_7nm_set_rate(struct clk_hw *hw, unsigned long rate,
 
 	dsi_pll_setup_config(pll, rsc);
 
-	dsi_pll_calc_dec_frac(pll, rsc);
-
-	dsi_pll_calc_ssc(pll, rsc);
+	dsi_pll_calc_regs(pll, rsc);
 
 	dsi_pll_commit(pll, rsc);
 
@@ -1295,7 +1432,7 @@ static int shadow_vco_7nm_set_rate(struct clk_hw *hw, unsigned long rate,
 
 	dsi_pll_setup_config(pll, rsc);
 
-	dsi_pll_calc_dec_frac(pll, rsc);
+	dsi_pll_calc_regs(pll, rsc);
 
 	/* program dynamic refresh control registers */
 	shadow_dsi_pll_dynamic_refresh_7nm(pll, rsc);
@@ -2684,6 +2821,10 @@ int dsi_pll_clock_register_7nm(struct platform_device *pdev,
 				of_clk_src_onecell_get, clk_data);
 	}
 	if (!rc) {
+		dsi_pll_presolve_dfps_rates(&plls[ndx], pll_res,
+				ndx ? dsi1pll_shadow_vco_clk.ref_clk_rate :
+				dsi0pll_shadow_vco_clk.ref_clk_rate);
+
 		pr_info("Registered DSI PLL ndx=%d, clocks successfully\n",
 				ndx);
 
@@ -1128,6 +1128,7 @@ static int sde_rotator_init_queue(struct sde_rot_mgr *mgr)
 
 		/* timeline not used */
 		mgr->commitq[i].timeline = NULL;
+		sde_rotator_latency_init(&mgr->commitq[i].latency);
 	}
 
 	size = sizeof(struct sde_rot_queue) * mgr->queue_count;
@@ -1190,6 +1191,147 @@ static void sde_rotator_deinit_queue(struct sde_rot_mgr *mgr)
 	mgr->queue_count = 0;
 }
 
+/*
+ * sde_rotator_select_queue() - select the commit queue for a rotation entry
+ * @mgr:	Rotator manager.
+ * @entry:	Rotation entry to be scheduled
+ * @perf:	Performance configuration of the owning session
+ *
+ * Entries are only balanced if every queue has its own hw resource. When
+ * all queues drive the same rotator, as the r1 and r3 backends do, the
+ * requested queue is kept: on r3 its index is the hw priority.
+ *
+ * With independent hw, entries of a session with work still assigned
+ * stay on the queue of that work so that per-session ordering is preserved.
+ * Otherwise the queue with the earliest estimated completion time is
+ * selected, estimated from the outstanding entries and the average hw time
+ * of each queue. Ties are resolved in favor of the queue requested by the
+ * client.
+ */
+static u32 sde_rotator_select_queue(struct sde_rot_mgr *mgr,
+	struct sde_rot_entry *entry, struct sde_rot_perf *perf)
+{
+	struct sde_rot_queue *queue;
+	u32 wb_idx = entry->item.wb_idx;
+	u64 cost, best_cost;
+	u32 pending, i;
+
+	if (wb_idx >= mgr->queue_count)
+		wb_idx = mgr->queue_count - 1;
+
+	/* inline rotation is bound to the queue of its trigger */
+	if (mgr->queue_count == 1 || !mgr->independent_hw ||
+			entry->item.output.sbuf)
+		return wb_idx;
+
+	if (perf->assigned_count && perf->last_wb_idx >= 0 &&
+			perf->last_wb_idx < mgr->queue_count)
+		return perf->last_wb_idx;
+
+	best_cost = U64_MAX;
+	for (i = 0; i < mgr->queue_count; i++) {
+		queue = &mgr->commitq[i];
+		pending = queue->hw ? queue->hw->pending_count : 0;
+		cost = (u64)(pending + 1) * max_t(u64, queue->avg_hw_time_us, 1);
+
+		if (cost < best_cost || (cost == best_cost &&
+				i == entry->item.wb_idx)) {
+			best_cost = cost;
+			wb_idx = i;
+		}
+	}
+
+	return wb_idx;
+}
+
+/*
+ * sde_rotator_update_queue_stats() - account latency of a completed entry
+ * @queue:	Commit queue the entry was scheduled on
+ * @entry:	Completed rotation entry
+ *
+ * Caller is expected to hold the rotator manager lock.
+ */
+static void sde_rotator_update_queue_stats(struct sde_rot_queue *queue,
+	struct sde_rot_entry *entry)
+{
+	s64 hw_time_us;
+
+	if (!queue || !entry->item.ts)
+		return;
+
+	sde_rotator_latency_record(&queue->latency, entry->item.ts,
+			SDE_ROTATOR_LAT_FENCE);
+	sde_rotator_latency_record(&queue->latency, entry->item.ts,
+			SDE_ROTATOR_LAT_QUEUE);
+	sde_rotator_latency_record(&queue->latency, entry->item.ts,
+			SDE_ROTATOR_LAT_HW);
+
+	hw_time_us = ktime_us_delta(entry->item.ts[SDE_ROTATOR_TS_DONE],
+			entry->item.ts[SDE_ROTATOR_TS_FLUSH]);
+	if (hw_time_us <= 0)
+		return;
+
+	if (!queue->avg_hw_time_us)
+		queue->avg_hw_time_us = hw_time_us;
+	else
+		queue->avg_hw_time_us =
+			(queue->avg_hw_time_us * 7 + hw_time_us) >> 3;
+}
+
+static const struct {
+	const char *name;
+	int start;
+	int end;
+} sde_rotator_latency_stages[SDE_ROTATOR_LAT_MAX] = {
+	[SDE_ROTATOR_LAT_FENCE] = {"fence",
+		SDE_ROTATOR_TS_FENCE, SDE_ROTATOR_TS_QUEUE},
+	[SDE_ROTATOR_LAT_QUEUE] = {"queue",
+		SDE_ROTATOR_TS_QUEUE, SDE_ROTATOR_TS_COMMIT},
+	[SDE_ROTATOR_LAT_HW] = {"hw",
+		SDE_ROTATOR_TS_FLUSH, SDE_ROTATOR_TS_DONE},
+	[SDE_ROTATOR_LAT_DEQUEUE] = {"dequeue",
+		SDE_ROTATOR_TS_DONE, SDE_ROTATOR_TS_DSTDQB},
+};
+
+void sde_rotator_latency_init(struct sde_rot_latency *lat)
+{
+	int i;
+
+	for (i = 0; i < SDE_ROTATOR_LAT_MAX; i++)
+		sde_rot_hist_init(&lat->stage[i]);
+}
+
+void sde_rotator_latency_record(struct sde_rot_latency *lat, ktime_t *ts,
+	enum sde_rotator_latency_stage stage)
+{
+	ktime_t start, end;
+
+	if (!lat || !ts || stage >= SDE_ROTATOR_LAT_MAX)
+		return;
+
+	start = ts[sde_rotator_latency_stages[stage].start];
+	end = ts[sde_rotator_latency_stages[stage].end];
+
+	/* skip stages that were not reached by this request */
+	if (!ktime_to_ns(start) || ktime_before(end, start))
+		return;
+
+	sde_rot_hist_add(&lat->stage[stage], ktime_us_delta(end, start));
+}
+
+int sde_rotator_latency_show(struct sde_rot_latency *lat, char *buf,
+	size_t len)
+{
+	int i, cnt = 0;
+
+	for (i = 0; i < SDE_ROTATOR_LAT_MAX; i++)
+		cnt += sde_rot_hist_print(&lat->stage[i],
+				sde_rotator_latency_stages[i].name,
+				buf + cnt, len - cnt);
+
+	return cnt;
+}
+
 /*
  * sde_rotator_assign_queue() - Function assign rotation work onto hw
  * @mgr:	Rotator manager.
@@ -1209,18 +1351,24 @@ static int sde_rotator_assign_queue(struct sde_rot_mgr *mgr,
 	struct sde_rot_queue *queue;
 	struct sde_rot_hw_resource *hw;
 	struct sde_rotation_item *item = &entry->item;
-	u32 wb_idx = item->wb_idx;
 	u32 pipe_idx = item->pipe_idx;
+	u32 wb_idx;
 	int ret = 0;
 
-	if (wb_idx >= mgr->queue_count) {
-		/* assign to the lowest priority queue */
-		wb_idx = mgr->queue_count - 1;
+	perf = sde_rotator_find_session(private, item->session_id);
+	if (!perf) {
+		SDEROT_ERR(
+			"Could not find session based on rotation work item\n");
+		return -EINVAL;
 	}
 
+	wb_idx = sde_rotator_select_queue(mgr, entry, perf);
+	item->wb_idx = wb_idx;
+
 	entry->doneq = &mgr->doneq[wb_idx];
-	entry->commitq = &mgr->commitq[wb_idx];
-	queue = mgr->commitq;
+
+	/* a single rotator is driven through the hw of the first queue */
+	queue = mgr->independent_hw ? &mgr->commitq[wb_idx] : mgr->commitq;
 
 	if (!queue->hw) {
 		hw = mgr->ops_hw_alloc(mgr, pipe_idx, wb_idx);
@@ -1232,21 +1380,18 @@ static int sde_rotator_assign_queue(struct sde_rot_mgr *mgr,
 		}
 	}
 
+	entry->perf = perf;
+
 	if (queue->hw) {
 		entry->commitq = queue;
 		queue->hw->pending_count++;
-	}
+		queue->dispatch_cnt++;
 
-	perf = sde_rotator_find_session(private, item->session_id);
-	if (!perf) {
-		SDEROT_ERR(
-			"Could not find session based on rotation work item\n");
-		return -EINVAL;
+		/* released in sde_rotator_unassign_queue */
+		perf->last_wb_idx = wb_idx;
+		perf->assigned_count++;
 	}
 
-	entry->perf = perf;
-	perf->last_wb_idx = wb_idx;
-
 	return ret;
 }
 
@@ -1262,6 +1407,9 @@ static void sde_rotator_unassign_queue(struct sde_rot_mgr *mgr,
 	entry->commitq = NULL;
 	entry->doneq = NULL;
 
+	if (entry->perf && entry->perf->assigned_count)
+		entry->perf->assigned_count--;
+
 	if (!queue->hw) {
 		SDEROT_ERR("entry assigned a queue with no hw\n");
 		return;
@@ -1331,21 +1479,91 @@ static u32 sde_rotator_calc_buf_bw(struct sde_mdp_format_params *fmt,
 	return bw;
 }
 
-static int sde_rotator_find_max_fps(struct sde_rot_mgr *mgr)
+/*
+ * sde_rotator_track_fps - account session frame rate into the peak fps
+ * @mgr: Pointer to rotator manager
+ * @perf: Pointer to session performance configuration
+ */
+static void sde_rotator_track_fps(struct sde_rot_mgr *mgr,
+		struct sde_rot_perf *perf)
+{
+	u32 fps = perf->config.frame_rate;
+
+	if (fps > mgr->max_fps) {
+		mgr->max_fps = fps;
+		mgr->max_fps_cnt = 1;
+	} else if (fps == mgr->max_fps) {
+		mgr->max_fps_cnt++;
+	}
+}
+
+/*
+ * sde_rotator_untrack_fps - remove session frame rate from the peak fps
+ * @mgr: Pointer to rotator manager
+ * @perf: Pointer to session performance configuration
+ *
+ * Sessions are only rescanned when the last session running at the
+ * peak frame rate goes away; @perf is skipped so the caller may still
+ * have it linked on its file perf_list.
+ */
+static void sde_rotator_untrack_fps(struct sde_rot_mgr *mgr,
+		struct sde_rot_perf *perf)
 {
 	struct sde_rot_file_private *priv;
-	struct sde_rot_perf *perf;
-	int max_fps = 0;
+	struct sde_rot_perf *p;
+
+	if (perf->config.frame_rate != mgr->max_fps)
+		return;
+
+	if (mgr->max_fps_cnt > 1) {
+		mgr->max_fps_cnt--;
+		return;
+	}
 
+	mgr->max_fps = 0;
+	mgr->max_fps_cnt = 0;
 	list_for_each_entry(priv, &mgr->file_list, list) {
-		list_for_each_entry(perf, &priv->perf_list, list) {
-			if (perf->config.frame_rate > max_fps)
-				max_fps = perf->config.frame_rate;
+		list_for_each_entry(p, &priv->perf_list, list) {
+			if (p != perf)
+				sde_rotator_track_fps(mgr, p);
 		}
 	}
+}
 
-	SDEROT_DBG("Max fps:%d\n", max_fps);
-	return max_fps;
+/*
+ * sde_rotator_add_session_perf - account session demand into manager
+ * @mgr: Pointer to rotator manager
+ * @perf: Pointer to session performance configuration
+ */
+static void sde_rotator_add_session_perf(struct sde_rot_mgr *mgr,
+		struct sde_rot_perf *perf)
+{
+	mgr->active_bw += perf->bw;
+	sde_rotator_track_fps(mgr, perf);
+}
+
+/*
+ * sde_rotator_del_session_perf - remove session demand from manager
+ * @mgr: Pointer to rotator manager
+ * @perf: Pointer to session performance configuration
+ */
+static void sde_rotator_del_session_perf(struct sde_rot_mgr *mgr,
+		struct sde_rot_perf *perf)
+{
+	if (mgr->active_bw < perf->bw) {
+		SDEROT_ERR("active bw underflow %llu / %llu\n",
+				mgr->active_bw, perf->bw);
+		mgr->active_bw = 0;
+	} else {
+		mgr->active_bw -= perf->bw;
+	}
+	sde_rotator_untrack_fps(mgr, perf);
+}
+
+static int sde_rotator_find_max_fps(struct sde_rot_mgr *mgr)
+{
+	SDEROT_DBG("Max fps:%u\n", mgr->max_fps);
+	return mgr->max_fps;
 }
 
 static int sde_rotator_calc_perf(struct sde_rot_mgr *mgr,
@@ -1456,20 +1674,13 @@ static int sde_rotator_calc_perf(struct sde_rot_mgr *mgr,
 
 static int sde_rotator_update_perf(struct sde_rot_mgr *mgr)
 {
-	struct sde_rot_file_private *priv;
-	struct sde_rot_perf *perf;
 	int not_in_suspend_mode;
 	u64 total_bw = 0;
 
 	not_in_suspend_mode = !atomic_read(&mgr->device_suspended);
 
-	if (not_in_suspend_mode) {
-		list_for_each_entry(priv, &mgr->file_list, list) {
-			list_for_each_entry(perf, &priv->perf_list, list) {
-				total_bw += perf->bw;
-			}
-		}
-	}
+	if (not_in_suspend_mode)
+		total_bw = mgr->active_bw;
 
 	total_bw += mgr->pending_close_bw_vote;
 	total_bw = max_t(u64, total_bw, mgr->minimum_bw_vote);
@@ -1755,6 +1966,7 @@ static void sde_rotator_done_handler(struct kthread_work *work)
 			&rot_trace);
 
 	sde_rot_mgr_lock(mgr);
+	sde_rotator_update_queue_stats(entry->commitq, entry);
 	sde_rotator_put_hw_resource(entry->commitq, entry, entry->commitq->hw);
 	sde_rotator_signal_output(entry);
 	ATRACE_INT("sde_rot_done", 1);
@@ -2230,6 +2442,7 @@ static void sde_rotator_release_rotator_perf_session(
 	sde_rotator_cancel_all_requests(mgr, private);
 
 	list_for_each_entry_safe(perf, perf_next, &private->perf_list, list) {
+		sde_rotator_del_session_perf(mgr, perf);
 		list_del_init(&perf->list);
 		devm_kfree(&mgr->pdev->dev, perf->work_distribution);
 		devm_kfree(&mgr->pdev->dev, perf);
@@ -2316,6 +2529,7 @@ static int sde_rotator_open_session(struct sde_rot_mgr *mgr,
 
 	INIT_LIST_HEAD(&perf->list);
 	list_add(&perf->list, &private->perf_list);
+	sde_rotator_add_session_perf(mgr, perf);
 
 	ret = sde_rotator_resource_ctrl(mgr, true);
 	if (ret < 0) {
@@ -2345,6 +2559,7 @@ enable_clk_err:
 update_clk_err:
 	sde_rotator_resource_ctrl(mgr, false);
 resource_err:
+	sde_rotator_del_session_perf(mgr, perf);
 	list_del_init(&perf->list);
 	devm_kfree(&mgr->pdev->dev, perf->work_distribution);
 alloc_err:
@@ -2372,6 +2587,7 @@ static int sde_rotator_close_session(struct sde_rot_mgr *mgr,
 		mgr->pending_close_bw_vote += perf->bw;
 		offload_release_work = true;
 	}
+	sde_rotator_del_session_perf(mgr, perf);
 	list_del_init(&perf->list);
 
 	if (offload_release_work)
@@ -2414,14 +2630,19 @@ static int sde_rotator_config_session(struct sde_rot_mgr *mgr,
 		return -EINVAL;
 	}
 
+	sde_rotator_del_session_perf(mgr, perf);
 	perf->config = *config;
+	sde_rotator_track_fps(mgr, perf);
 	ret = sde_rotator_calc_perf(mgr, perf);
-
 	if (ret) {
+		/* nothing is accounted, so close must not subtract anything */
+		perf->bw = 0;
 		SDEROT_ERR("error in configuring the session %d\n", ret);
 		goto done;
 	}
 
+	mgr->active_bw += perf->bw;
+
 	ret = sde_rotator_update_perf(mgr);
 	if (ret) {
 		SDEROT_ERR("error in updating perf: %d\n", ret);
@@ -2738,10 +2959,18 @@ static ssize_t state_show(struct device *dev,
 	SPRINT("reg_bus_bw=%llu\n", mgr->reg_bus.curr_quota_val);
 	SPRINT("data_bus_bw=%llu\n", mgr->data_bus.curr_quota_val);
 	SPRINT("pending_close_bw_vote=%llu\n", mgr->pending_close_bw_vote);
+	SPRINT("active_bw=%llu\n", mgr->active_bw);
+	SPRINT("max_fps=%u (%u sessions)\n", mgr->max_fps, mgr->max_fps_cnt);
 	SPRINT("device_suspended=%d\n", atomic_read(&mgr->device_suspended));
 	SPRINT("footswitch_cnt=%d\n", mgr->res_ref_cnt);
 	SPRINT("regulator_enable=%d\n", mgr->regulator_enable);
 	SPRINT("enable_clk_cnt=%d\n", mgr->rot_enable_clk_cnt);
+	for (i = 0; mgr->commitq && i < mgr->queue_count; i++)
+		SPRINT("queue%d: pending=%u dispatched=%llu avg_hw_us=%llu\n",
+			i, mgr->commitq[i].hw ?
+				mgr->commitq[i].hw->pending_count : 0,
+			mgr->commitq[i].dispatch_cnt,
+			mgr->commitq[i].avg_hw_time_us);
 	for (i = 0; i < mgr->num_rot_clk; i++)
 		if (mgr->rot_clk[i].clk)
 			SPRINT("%s=%lu\n", mgr->rot_clk[i].clk_name,
@@ -2753,11 +2982,33 @@ static ssize_t state_show(struct device *dev,
 	return cnt;
 }
 
+static ssize_t latency_show(struct device *dev,
+		struct device_attribute *attr, char *buf)
+{
+	size_t len = PAGE_SIZE;
+	int cnt = 0;
+	struct sde_rot_mgr *mgr = sde_rot_mgr_from_device(dev);
+	int i;
+
+	if (!mgr || !mgr->commitq)
+		return cnt;
+
+	for (i = 0; i < mgr->queue_count; i++) {
+		cnt += scnprintf(buf + cnt, len - cnt, "queue%d:\n", i);
+		cnt += sde_rotator_latency_show(&mgr->commitq[i].latency,
+				buf + cnt, len - cnt);
+	}
+
+	return cnt;
+}
+
 static DEVICE_ATTR_RO(caps);
 static DEVICE_ATTR_RO(state);
+static DEVICE_ATTR_RO(latency);
 
 static struct attribute *sde_rotator_fs_attrs[] = {
 	&dev_attr_caps.attr,
+	&dev_attr_latency.attr,
 	&dev_attr_state.attr,
 	NULL
 };
@@ -116,6 +116,25 @@ enum sde_rotator_ts {
 	SDE_ROTATOR_TS_MAX
 };
 
+/*
+ * Latency stages derived from the timestamps above, in usec
+ */
+enum sde_rotator_latency_stage {
+	SDE_ROTATOR_LAT_FENCE,		/* source fence to queue */
+	SDE_ROTATOR_LAT_QUEUE,		/* queue to commit, h/w resource wait */
+	SDE_ROTATOR_LAT_HW,		/* flush to h/w completion */
+	SDE_ROTATOR_LAT_DEQUEUE,	/* h/w completion to destination dqbuf */
+	SDE_ROTATOR_LAT_MAX
+};
+
+/*
+ * struct sde_rot_latency - latency histogram per stage
+ * @stage: histogram of each latency stage
+ */
+struct sde_rot_latency {
+	struct sde_rot_hist stage[SDE_ROTATOR_LAT_MAX];
+};
+
 enum sde_rotator_clk_type {
 	SDE_ROTATOR_CLK_MDSS_AHB,
 	SDE_ROTATOR_CLK_MDSS_AXI,
@@ -227,11 +246,24 @@ struct sde_rot_hw_resource {
 	wait_queue_head_t wait_queue;
 };
 
+/*
+ * struct sde_rot_queue - rotator commit/done queue
+ * @rot_kw: kthread worker servicing this queue
+ * @rot_thread: kthread task of @rot_kw
+ * @timeline: fence timeline of this queue (not used)
+ * @hw: hw resource currently attached to this queue
+ * @avg_hw_time_us: moving average of flush to done time in usec
+ * @dispatch_cnt: number of entries scheduled onto this queue
+ * @latency: latency histograms of entries completed on this queue
+ */
 struct sde_rot_queue {
 	struct kthread_worker rot_kw;
 	struct task_struct *rot_thread;
 	struct sde_rot_timeline *timeline;
 	struct sde_rot_hw_resource *hw;
+	u64 avg_hw_time_us;
+	u64 dispatch_cnt;
+	struct sde_rot_latency latency;
 };
 
 struct sde_rot_queue_v1 {
@@ -343,6 +375,7 @@ struct sde_rot_trace_entry {
  * @work_dis_lock: serialization lock for updating work distribution (not used)
  * @work_distribution: work distribution among multiple hardware queue/unit
  * @last_wb_idx: last queue/unit index, used to account for pre-distributed work
+ * @assigned_count: number of entries of this session assigned to a queue
  * @rdot_limit: read OT limit of this session
  * @wrot_limit: write OT limit of this session
  */
@@ -354,6 +387,7 @@ struct sde_rot_perf {
 	struct mutex work_dis_lock;
 	u32 *work_distribution;
 	int last_wb_idx; /* last known wb index, used when above count is 0 */
+	u32 assigned_count;
 	u32 rdot_limit;
 	u32 wrot_limit;
 };
@@ -395,9 +429,14 @@ struct sde_rot_bus_data_type {
  * @pdev: pointer to controlling platform device
  * @device: pointer to controlling device
  * @queue_count: number of hardware queue/unit available
+ * @independent_hw: true if every hardware queue has its own hw resource,
+ *	only then are entries balanced across queues
  * @commitq: array of rotator commit queue corresponding to hardware queue
  * @doneq: array of rotator done queue corresponding to hardware queue
  * @file_list: list of all sessions managed by rotator manager
+ * @active_bw: aggregate bandwidth of all open sessions
+ * @max_fps: peak frame rate of all open sessions
+ * @max_fps_cnt: number of open sessions running at @max_fps
  * @pending_close_bw_vote: bandwidth of closed sessions with pending work
  * @minimum_bw_vote: minimum bandwidth required for current use case
  * @enable_bw_vote: minimum bandwidth required for power enable
@@ -432,6 +471,7 @@ struct sde_rot_mgr {
 	 * how many hw pipes available on the system
 	 */
 	int queue_count;
+	bool independent_hw;
 	struct sde_rot_queue *commitq;
 	struct sde_rot_queue *doneq;
 
@@ -441,6 +481,14 @@ struct sde_rot_mgr {
 	 */
 	struct list_head file_list;
 
+	/*
+	 * aggregate session demand, maintained incrementally on session
+	 * open/config/close so perf updates need not walk file_list
+	 */
+	u64 active_bw;
+	u32 max_fps;
+	u32 max_fps_cnt;
+
 	u64 pending_close_bw_vote;
 	u64 minimum_bw_vote;
 	u64 enable_bw_vote;
@@ -792,6 +840,31 @@ static inline int sde_rotator_resource_ctrl_enabled(struct sde_rot_mgr *mgr)
 	return mgr->regulator_enable;
 }
 
+/*
+ * sde_rotator_latency_init - initialize latency histograms
+ * @lat: Pointer to latency histograms
+ */
+void sde_rotator_latency_init(struct sde_rot_latency *lat);
+
+/*
+ * sde_rotator_latency_record - record one latency stage of a request
+ * @lat: Pointer to latency histograms
+ * @ts: Timestamp array of the request, indexed by SDE_ROTATOR_TS_*
+ * @stage: Latency stage to record
+ */
+void sde_rotator_latency_record(struct sde_rot_latency *lat, ktime_t *ts,
+	enum sde_rotator_latency_stage stage);
+
+/*
+ * sde_rotator_latency_show - print percentiles of all latency stages
+ * @lat: Pointer to latency histograms
+ * @buf: Output buffer
+ * @len: Size of output buffer
+ * return: number of bytes written
+ */
+int sde_rotator_latency_show(struct sde_rot_latency *lat, char *buf,
+	size_t len);
+
 /*
  * sde_rotator_cancel_all_requests - cancel all outstanding requests
  * @mgr: Pointer to rotator manager
@@ -755,11 +755,27 @@ static ssize_t sde_rotator_ctx_show(struct kobject *kobj,
 	return cnt;
 }
 
+/*
+ * sde_rotator_ctx_latency_show - show context latency percentiles.
+ */
+static ssize_t sde_rotator_ctx_latency_show(struct kobject *kobj,
+	struct kobj_attribute *attr, char *buf)
+{
+	struct sde_rotator_ctx *ctx =
+		container_of(kobj, struct sde_rotator_ctx, kobj);
+
+	return sde_rotator_latency_show(&ctx->latency, buf, PAGE_SIZE);
+}
+
 static struct kobj_attribute sde_rotator_ctx_attr =
 	__ATTR(state, 0664, sde_rotator_ctx_show, NULL);
 
+static struct kobj_attribute sde_rotator_ctx_latency_attr =
+	__ATTR(latency, 0444, sde_rotator_ctx_latency_show, NULL);
+
 static struct attribute *sde_rotator_fs_attrs[] = {
 	&sde_rotator_ctx_attr.attr,
+	&sde_rotator_ctx_latency_attr.attr,
 	NULL
 };
 
@@ -935,6 +951,7 @@ struct sde_rotator_ctx *sde_rotator_ctx_open(
 	spin_lock_init(&ctx->list_lock);
 	INIT_LIST_HEAD(&ctx->pending_list);
 	INIT_LIST_HEAD(&ctx->retired_list);
+	sde_rotator_latency_init(&ctx->latency);
 
 	for (i = 0 ; i < ARRAY_SIZE(ctx->requests); i++) {
 		struct sde_rotator_request *request = &ctx->requests[i];
@@ -2416,8 +2433,15 @@ static int sde_rotator_dqbuf(struct file *file,
 		}
 		ctx->vbinfo_cap[idx].fence = NULL;
 		ctx->vbinfo_cap[idx].fd = -1;
-		if (ctx->vbinfo_cap[idx].dqbuf_ts)
-			*(ctx->vbinfo_cap[idx].dqbuf_ts) = ktime_get();
+		if (ctx->vbinfo_cap[idx].dqbuf_ts) {
+			ktime_t *ts = ctx->vbinfo_cap[idx].dqbuf_ts -
+					SDE_ROTATOR_TS_DSTDQB;
+			int i;
+
+			ts[SDE_ROTATOR_TS_DSTDQB] = ktime_get();
+			for (i = 0; i < SDE_ROTATOR_LAT_MAX; i++)
+				sde_rotator_latency_record(&ctx->latency, ts, i);
+		}
 	} else if ((buf->type == V4L2_BUF_TYPE_VIDEO_OUTPUT)
 			&& (buf->index < ctx->nbuf_out)) {
 		int idx = buf->index;
@@ -3117,6 +3141,7 @@ static int sde_rotator_process_buffers(struct sde_rotator_ctx *ctx,
 
 	/* allocate slot for timestamp */
 	ts = stats->ts[stats->count++ % SDE_ROTATOR_NUM_EVENTS];
+	memset(ts, 0, sizeof(stats->ts[0]));
 	ts[SDE_ROTATOR_TS_SRCQB] = vbinfo_out->qbuf_ts;
 	ts[SDE_ROTATOR_TS_DSTQB] = vbinfo_cap->qbuf_ts;
 	vbinfo_out->dqbuf_ts = &ts[SDE_ROTATOR_TS_SRCDQB];
@@ -133,6 +133,7 @@ struct sde_rotator_request {
  * @requests: static allocation of free requests
  * @rotcfg: current core rotation configuration
  * @kthread_id: thread_id used for fence management
+ * @latency: latency histograms of requests of this context
  */
 struct sde_rotator_ctx {
 	struct kobject kobj;
@@ -169,6 +170,7 @@ struct sde_rotator_ctx {
 	struct sde_rotation_config rotcfg;
 
 	int kthread_id;
+	struct sde_rot_latency latency;
 };
 
 /*
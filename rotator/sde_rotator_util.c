@@ -18,6 +18,7 @@
 #include <linux/slab.h>
 #include <linux/io.h>
 #include <linux/iopoll.h>
+#include <linux/math64.h>
 #include <linux/msm-bus.h>
 #include <linux/msm-bus-board.h>
 #include <linux/regulator/consumer.h>
@@ -1227,3 +1228,91 @@ struct dma_buf *sde_rot_get_dmabuf(struct sde_mdp_img_data *data)
 
 	return dma_buf_export(&exp_info);
 }
+
+void sde_rot_hist_init(struct sde_rot_hist *hist)
+{
+	memset(hist, 0, sizeof(*hist));
+	spin_lock_init(&hist->lock);
+	hist->min = U64_MAX;
+}
+
+static u32 sde_rot_hist_bucket(u64 val)
+{
+	u32 order;
+
+	if (val < SDE_ROT_HIST_SUB_BUCKETS)
+		return val;
+
+	order = fls64(val) - 1;
+	if (order >= SDE_ROT_HIST_MAX_ORDER)
+		return SDE_ROT_HIST_BUCKETS - 1;
+
+	return (order - SDE_ROT_HIST_SUB_BITS + 1) * SDE_ROT_HIST_SUB_BUCKETS +
+		((val >> (order - SDE_ROT_HIST_SUB_BITS)) &
+			(SDE_ROT_HIST_SUB_BUCKETS - 1));
+}
+
+static u64 sde_rot_hist_bucket_max(u32 idx)
+{
+	u32 order, sub;
+
+	if (idx < SDE_ROT_HIST_SUB_BUCKETS)
+		return idx;
+
+	order = idx / SDE_ROT_HIST_SUB_BUCKETS + SDE_ROT_HIST_SUB_BITS - 1;
+	sub = idx % SDE_ROT_HIST_SUB_BUCKETS;
+
+	return ((u64)(SDE_ROT_HIST_SUB_BUCKETS + sub + 1) <<
+			(order - SDE_ROT_HIST_SUB_BITS)) - 1;
+}
+
+void sde_rot_hist_add(struct sde_rot_hist *hist, u64 val)
+{
+	spin_lock(&hist->lock);
+	hist->bucket[sde_rot_hist_bucket(val)]++;
+	hist->count++;
+	hist->sum += val;
+	hist->min = min(hist->min, val);
+	hist->max = max(hist->max, val);
+	spin_unlock(&hist->lock);
+}
+
+/* caller is expected to hold hist->lock */
+static u64 sde_rot_hist_percentile(struct sde_rot_hist *hist, u32 permille)
+{
+	u64 target, seen = 0;
+	u32 i;
+
+	if (!hist->count)
+		return 0;
+
+	target = DIV_ROUND_UP_ULL(hist->count * permille, 1000);
+	for (i = 0; i < SDE_ROT_HIST_BUCKETS; i++) {
+		seen += hist->bucket[i];
+		if (seen >= target)
+			return min(sde_rot_hist_bucket_max(i), hist->max);
+	}
+
+	return hist->max;
+}
+
+int sde_rot_hist_print(struct sde_rot_hist *hist, const char *name,
+		char *buf, size_t len)
+{
+	u64 count, avg, p50, p90, p99, p999, min_val, max_val;
+
+	spin_lock(&hist->lock);
+	count = hist->count;
+	avg = count ? div64_u64(hist->sum, count) : 0;
+	min_val = count ? hist->min : 0;
+	max_val = hist->max;
+	p50 = sde_rot_hist_percentile(hist, 500);
+	p90 = sde_rot_hist_percentile(hist, 900);
+	p99 = sde_rot_hist_percentile(hist, 990);
+	p999 = sde_rot_hist_percentile(hist, 999);
+	spin_unlock(&hist->lock);
+
+	return scnprintf(buf, len,
+		"%s: n:%llu min:%llu avg:%llu max:%llu p50:%llu p90:%llu p99:%llu p999:%llu\n",
+		name, count, min_val, avg, max_val, p50, p90, p99, p999);
+}
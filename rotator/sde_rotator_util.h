@@ -10,6 +10,7 @@
 #include <linux/file.h>
 #include <linux/kref.h>
 #include <linux/kernel.h>
+#include <linux/spinlock.h>
 #include <linux/device.h>
 #include <linux/dma-buf.h>
 
@@ -37,6 +38,18 @@
 #define SDEDEV_ERR(dev, fmt, ...)	\
 	dev_err(dev, "<SDEROT_ERR> " fmt, ##__VA_ARGS__)
 
+/*
+ * Log-linear latency histogram: values below SDE_ROT_HIST_SUB_BUCKETS get
+ * one bucket each, every following power of two is split into
+ * SDE_ROT_HIST_SUB_BUCKETS linear buckets up to 2^SDE_ROT_HIST_MAX_ORDER.
+ */
+#define SDE_ROT_HIST_SUB_BITS		3
+#define SDE_ROT_HIST_SUB_BUCKETS	(1 << SDE_ROT_HIST_SUB_BITS)
+#define SDE_ROT_HIST_MAX_ORDER		24
+#define SDE_ROT_HIST_BUCKETS \
+	((SDE_ROT_HIST_MAX_ORDER - SDE_ROT_HIST_SUB_BITS + 1) * \
+		SDE_ROT_HIST_SUB_BUCKETS)
+
 #define PHY_ADDR_4G (1ULL<<32)
 
 struct sde_rect {
@@ -164,6 +177,24 @@ struct sde_mdp_data {
 	bool writeback;
 };
 
+/*
+ * struct sde_rot_hist - log-linear histogram of latency samples
+ * @lock: serialization lock for sample updates
+ * @count: number of samples
+ * @sum: sum of all samples
+ * @min: smallest sample
+ * @max: largest sample
+ * @bucket: sample count per bucket
+ */
+struct sde_rot_hist {
+	spinlock_t lock;
+	u64 count;
+	u64 sum;
+	u64 min;
+	u64 max;
+	u32 bucket[SDE_ROT_HIST_BUCKETS];
+};
+
 void sde_mdp_get_v_h_subsample_rate(u8 chroma_sample,
 		u8 *v_sample, u8 *h_sample);
 
@@ -196,4 +227,11 @@ int sde_mdp_data_check(struct sde_mdp_data *data,
 void sde_mdp_data_free(struct sde_mdp_data *data, bool rotator, int dir);
 
 struct dma_buf *sde_rot_get_dmabuf(struct sde_mdp_img_data *data);
+
+void sde_rot_hist_init(struct sde_rot_hist *hist);
+
+void sde_rot_hist_add(struct sde_rot_hist *hist, u64 val);
+
+int sde_rot_hist_print(struct sde_rot_hist *hist, const char *name,
+		char *buf, size_t len);
 #endif /* __SDE_ROTATOR_UTIL_H__ */